@@ -1,5 +1,10 @@
 // Arduino.h — RP2040 shim
 #pragma once
+#ifdef KLYSTRON_HOST_BUILD
+// The host build keeps its half of the shim next to the rest of the host
+// stand-ins; see host/include/host_arduino.h.
+#  include "host_arduino.h"
+#else
 #include <stdint.h>
 #include <stdbool.h>
 #include <math.h>
@@ -59,3 +64,4 @@ static inline void yield() { tight_loop_contents(); }
 // Use CPS so no CMSIS dependency
 static inline void noInterrupts() { __asm volatile("cpsid i" ::: "memory"); }
 static inline void interrupts()   { __asm volatile("cpsie i" ::: "memory"); }
+#endif // KLYSTRON_HOST_BUILD
@@ -1,9 +1,11 @@
 #ifndef ACTION_H
 #define ACTION_H
 
+#include <cstddef>
 #include <stdint.h>
 #include "animation.h"
-#include <memory>
+#include <new>
+#include <utility>
 
 class AnimationController; // Forward declaration
 
@@ -32,19 +34,6 @@ private:
     uint32_t elapsed_ms;
 };
 
-class PlayAnimationAction : public Action {
-public:
-    PlayAnimationAction(std::unique_ptr<Animation> anim, const AnimationConfig& config)
-        : animation(std::move(anim)), config(config) {}
-
-    void start(AnimationController* controller) override;
-    bool update(uint32_t dt) override;
-
-private:
-    std::unique_ptr<Animation> animation;
-    AnimationConfig config;
-};
-
 class ChangeColorAction : public Action {
 public:
     ChangeColorAction(CRGB color, uint32_t duration, ramp_mode mode = LINEAR)
@@ -73,17 +62,51 @@ private:
     ramp_mode mode;
 };
 
-#include <functional>
+/** @brief Bytes of captured state a CallbackAction can hold in place. */
+static const size_t ACTION_CALLBACK_CAPACITY = 16;
+
+/**
+ * @brief A `void()` callable stored inside the object, never on the heap.
+ * @details Anything that fits in `Capacity` bytes - a plain function, a
+ *          captureless lambda or a lambda capturing a few values - is
+ *          placement-constructed into the buffer. Larger callables are a
+ *          compile error rather than a silent allocation.
+ */
+template <size_t Capacity>
+class InplaceCallback {
+public:
+    template <typename F>
+    InplaceCallback(F f) {
+        static_assert(sizeof(F) <= Capacity,
+                      "callback captures too much state; raise ACTION_CALLBACK_CAPACITY");
+        static_assert(alignof(F) <= alignof(std::max_align_t),
+                      "callback is over-aligned");
+        new (storage) F(std::move(f));
+        invoke_fn = [](void* p) { (*static_cast<F*>(p))(); };
+        destroy_fn = [](void* p) { static_cast<F*>(p)->~F(); };
+    }
+
+    ~InplaceCallback() { destroy_fn(storage); }
+
+    InplaceCallback(const InplaceCallback&) = delete;
+    InplaceCallback& operator=(const InplaceCallback&) = delete;
+
+    void operator()() { invoke_fn(storage); }
+
+private:
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    void (*invoke_fn)(void*);
+    void (*destroy_fn)(void*);
+};
 
 class CallbackAction : public Action {
 public:
-    CallbackAction(std::function<void()> callback) : callback(callback) {}
+    template <typename F>
+    explicit CallbackAction(F callback) : callback(std::move(callback)) {}
 
     void start(AnimationController* controller) override {
         Action::start(controller);
-        if (callback) {
-            callback();
-        }
+        callback();
     }
 
     bool update(uint32_t dt) override {
@@ -91,7 +114,7 @@ public:
     }
 
 private:
-    std::function<void()> callback;
+    InplaceCallback<ACTION_CALLBACK_CAPACITY> callback;
 };
 
 #endif // ACTION_H
@@ -3,16 +3,29 @@
  * @brief Low-level driver for addressable LED strips.
  * @details This file provides initialization and a centralized update function
  *          (`show_leds`) for all addressable LED strips (Powercell, Cyclotron, Future).
- *          It wraps the FastLED library calls and includes the crucial cyclotron
- *          LED masking logic.
+ *          It wraps the FastLED library calls. LEDs past the active cyclotron
+ *          count are kept dark by the cyclotron controller's mask layer.
  * @copyright
  *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
  *   Licensed under the MIT License. See LICENSE file for details.
  */
 
 #include "addressable_LED_support.h"
-#include "Ramp.h"
-#include "cyclotron_sequences.h"
+#include "RampFixed.h"
+#include "led_core.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "pico/time.h"
+#include <string.h>
+
+/**
+ * @brief Time a strip needs after its DMA transfer completes, in microseconds.
+ * @details Covers draining the PIO TX FIFO (four 32-bit words at 1.25 us per
+ *          bit) plus the 50 us WS2812 reset latch. FastLED's driver waits out
+ *          the same interval inside `show()`, so a strip is only handed back
+ *          to it once this has passed.
+ */
+#define LED_LATCH_US 250
 
 // Define the CRGB arrays for each strip
 CRGB g_powercell_leds[NUM_LEDS_POWERCELL];
@@ -20,23 +33,132 @@ CRGB g_cyclotron_leds[NUM_LEDS_CYCLOTRON];
 CRGB g_future_leds[NUM_LEDS_FUTURE];
 
 // Ramp object controlling global LED brightness
-static rampByte g_brightness_ramp(255);
+static rampFixedByte g_brightness_ramp(255);
+
+/**
+ * @brief A physical strip, its FastLED controller and the frame last sent to it.
+ * @details The `g_*_leds` arrays are the back buffers that animations draw
+ *          into. FastLED's RP2040 driver encodes each frame into its own DMA
+ *          buffer before starting the transfer, which makes that buffer the
+ *          front buffer, so `show_leds` only needs to know when a strip's
+ *          transfer is still on the wire.
+ */
+struct LedStrip {
+  CLEDController *controller;
+  const CRGB *leds;
+  CRGB *shown;                  ///< Copy of the frame last sent
+  uint16_t num_leds;
+  int16_t shown_brightness;     ///< Brightness it was sent at; -1 before the first frame
+  int dma_channel;              ///< FastLED's channel, or -1 when output is synchronous
+  volatile bool in_flight;      ///< Cleared by the DMA completion interrupt
+  volatile uint32_t done_us;    ///< When the last transfer completed
+};
+
+// Copies of what each strip is currently displaying
+static CRGB s_powercell_shown[NUM_LEDS_POWERCELL];
+static CRGB s_cyclotron_shown[NUM_LEDS_CYCLOTRON];
+static CRGB s_future_shown[NUM_LEDS_FUTURE];
+
+static LedStrip s_strips[3];
+
+/**
+ * @brief Returns a bit mask of the DMA channels currently claimed.
+ */
+static uint32_t claimed_dma_channels() {
+  uint32_t mask = 0;
+  for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+    if (dma_channel_is_claimed(ch)) {
+      mask |= 1u << ch;
+    }
+  }
+  return mask;
+}
+
+/**
+ * @brief Records a strip just added to FastLED.
+ * @details FastLED's driver claims one DMA channel per controller inside
+ *          `addLeds`, so the channel claimed since `claimed_before` is the
+ *          one feeding this strip.
+ * @return The claimed-channel mask to pass for the next strip.
+ */
+static uint32_t add_strip(LedStrip &strip, CLEDController &controller, CRGB *leds,
+                          CRGB *shown, uint16_t num_leds, uint32_t claimed_before) {
+  uint32_t claimed = claimed_dma_channels();
+  uint32_t added = claimed & ~claimed_before;
+
+  strip.controller = &controller;
+  strip.leds = leds;
+  strip.shown = shown;
+  strip.num_leds = num_leds;
+  strip.shown_brightness = -1;
+  strip.dma_channel = added ? __builtin_ctz(added) : -1;
+  strip.in_flight = false;
+  strip.done_us = time_us_32() - LED_LATCH_US;
+  return claimed;
+}
+
+/**
+ * @brief DMA_IRQ_0 handler marking LED transfers as complete.
+ * @details Registered ahead of FastLED's own handler on the shared IRQ, so
+ *          the channel status is read before FastLED acknowledges it.
+ */
+static void led_dma_complete_isr(void) {
+  for (LedStrip &strip : s_strips) {
+    if (strip.in_flight && strip.dma_channel >= 0 &&
+        dma_channel_get_irq0_status(strip.dma_channel)) {
+      strip.done_us = time_us_32();
+      strip.in_flight = false;
+    }
+  }
+}
+
+/**
+ * @brief Whether a strip can take a new frame without FastLED blocking.
+ */
+static bool strip_ready(const LedStrip &strip) {
+  if (strip.dma_channel < 0) {
+    return true;
+  }
+  return !strip.in_flight && (time_us_32() - strip.done_us) >= LED_LATCH_US;
+}
 
 /**
  * @brief Initializes all LED strips via the FastLED library.
  * @details Configures the controller, pin, and color order for each of the
- *          three physical LED strips.
+ *          three physical LED strips, then hooks the DMA completion interrupt
+ *          so `show_leds` can hand off frames without waiting on the wire.
  */
 void init_leds() {
+  uint32_t claimed = claimed_dma_channels();
+  bool any_dma = false;
+
   // Initialize the Powercell LEDs with explicit GRB color order
-  FastLED.addLeds<WS2812B, POWERCELL_PIN, GRB>(g_powercell_leds, NUM_LEDS_POWERCELL);
+  claimed = add_strip(s_strips[0],
+                      FastLED.addLeds<WS2812B, POWERCELL_PIN, GRB>(g_powercell_leds, NUM_LEDS_POWERCELL),
+                      g_powercell_leds, s_powercell_shown, NUM_LEDS_POWERCELL, claimed);
 
   // Initialize the Cyclotron LEDs with explicit GRB color order to ensure
   // red renders correctly on all hardware revisions
-  FastLED.addLeds<WS2812B, CYCLOTRON_PIN, GRB>(g_cyclotron_leds, NUM_LEDS_CYCLOTRON);
+  claimed = add_strip(s_strips[1],
+                      FastLED.addLeds<WS2812B, CYCLOTRON_PIN, GRB>(g_cyclotron_leds, NUM_LEDS_CYCLOTRON),
+                      g_cyclotron_leds, s_cyclotron_shown, NUM_LEDS_CYCLOTRON, claimed);
 
   // Initialize the Future LEDs with explicit GRB color order
-  FastLED.addLeds<WS2812B, FUTURE_PIN, GRB>(g_future_leds, NUM_LEDS_FUTURE);
+  claimed = add_strip(s_strips[2],
+                      FastLED.addLeds<WS2812B, FUTURE_PIN, GRB>(g_future_leds, NUM_LEDS_FUTURE),
+                      g_future_leds, s_future_shown, NUM_LEDS_FUTURE, claimed);
+
+  for (const LedStrip &strip : s_strips) {
+    any_dma |= strip.dma_channel >= 0;
+  }
+  if (any_dma) {
+    irq_add_shared_handler(DMA_IRQ_0, led_dma_complete_isr,
+                           PICO_SHARED_IRQ_HANDLER_HIGHEST_ORDER_PRIORITY);
+  }
+
+  // show_leds() never hands FastLED a busy strip, so its 400 Hz refresh cap
+  // (a busy-wait in FastLED.show()) is no longer needed.
+  FastLED.setMaxRefreshRate(0, false);
 
   // Start with full brightness
   FastLED.setBrightness(g_brightness_ramp.getValue());
@@ -49,41 +171,51 @@ void init_leds() {
  */
 void set_led_brightness(uint8_t brightness, unsigned long duration) {
   // Use a quadratic easing curve for smoother fades that start gently
-  // and accelerate toward the target brightness.
-  g_brightness_ramp.go(brightness, duration, QUADRATIC_INOUT);
-}
-
-/**
- * @brief Masks off unused cyclotron LEDs.
- * @details Ensures that all LEDs from the active count (N) to the physical
- *          total (40) are set to black, enforcing the "remainder off" rule.
- *          This is called by `show_leds` before updating the physical strips.
- */
-void mask_cyclotron_leds() {
-    // Clamp the active LED count to the physical strip size to guard
-    // against accidental overruns that could corrupt adjacent memory.
-    if (g_cyclotron_led_count > NUM_LEDS_CYCLOTRON) {
-        g_cyclotron_led_count = NUM_LEDS_CYCLOTRON;
-    }
-
-    // Turn off all LEDs from the current count up to the physical max.
-    // This guarantees that modes which operate on N LEDs don't leave
-    // leftover pixels lit if N is reduced.
-    for (int i = g_cyclotron_led_count; i < NUM_LEDS_CYCLOTRON; i++) {
-        g_cyclotron_leds[i] = CRGB::Black;
-    }
+  // and accelerate toward the target brightness. The ramp belongs to
+  // whichever core shows the LEDs.
+  led_core_call([=]() { g_brightness_ramp.go(brightness, duration, QUADRATIC_INOUT); });
 }
 
 /**
  * @brief Pushes the current state of all LED buffers to the physical strips.
  * @details This function is the single point of truth for updating the hardware.
- *          It applies the brightness ramp and the cyclotron LED mask before
- *          calling `FastLED.show()`.
+ *          It applies the brightness ramp, then starts a transfer for every strip whose pixels or brightness differ
+ *          from the last frame sent to it. It never waits: a strip still
+ *          transmitting its previous frame stays dirty and is picked up by a
+ *          later call, and the DMA completion interrupt marks it free again.
+ *          When nothing needs sending, `FastLED.show()` is skipped entirely.
+ *          Once the LED core is running it shows every frame itself, so a
+ *          call from anywhere else returns immediately.
  */
 void show_leds() {
-  // Apply the cyclotron mask before showing the LEDs.
-  mask_cyclotron_leds();
+  if (led_core_defer()) {
+    return;
+  }
+
+  uint8_t brightness = g_brightness_ramp.update();
+  bool any_sent = false;
+
+  for (LedStrip &strip : s_strips) {
+    size_t bytes = strip.num_leds * sizeof(CRGB);
+    bool send = strip_ready(strip) &&
+                (brightness != strip.shown_brightness ||
+                 memcmp(strip.leds, strip.shown, bytes) != 0);
+    if (send) {
+      memcpy(strip.shown, strip.leds, bytes);
+      strip.shown_brightness = brightness;
+      strip.in_flight = strip.dma_channel >= 0;
+      any_sent = true;
+    }
+    // FastLED.show() skips disabled controllers.
+    strip.controller->setEnabled(send);
+  }
+
+  if (any_sent) {
+    FastLED.setBrightness(brightness);
+    FastLED.show();
+  }
 
-  FastLED.setBrightness(g_brightness_ramp.update());
-  FastLED.show();
+  for (LedStrip &strip : s_strips) {
+    strip.controller->setEnabled(true);
+  }
 }
@@ -48,15 +48,19 @@ extern "C" {
 /**
  * @brief Initializes all LED strips via the FastLED library.
  * @details Configures the controller, pin, and color order for each of the
- *          three physical LED strips.
+ *          three physical LED strips and hooks the DMA completion interrupt
+ *          used by `show_leds`.
  */
 void init_leds();
 
 /**
  * @brief Pushes the current state of all LED buffers to the physical strips.
  * @details This function is the single point of truth for updating the hardware.
- *          It applies the brightness ramp and the cyclotron LED mask before
- *          calling `FastLED.show()`.
+ *          It applies the brightness ramp, then starts a DMA transfer for each strip whose content or brightness
+ *          changed since it was last sent. It returns without waiting for the
+ *          wire; a strip still busy with its previous frame is sent on a
+ *          later call. In dual-core mode only the LED core's own call does
+ *          anything (see `led_core.h`).
  */
 void show_leds();
 
@@ -67,11 +71,6 @@ void show_leds();
  */
 void set_led_brightness(uint8_t brightness, unsigned long duration);
 
-/**
- * @brief Masks off unused cyclotron LEDs so the remainder stays dark.
- */
-void mask_cyclotron_leds();
-
 #ifdef __cplusplus
 }
 #endif
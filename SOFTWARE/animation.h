@@ -22,6 +22,7 @@ struct AnimationConfig {
     uint16_t fade_amount = 0;
     uint16_t steps = 0;
     bool bounce = false;
+    bool motion_blur = false; // Cylon and Rotate: draw between steps, with a trail when fast
 };
 
 /**
@@ -30,13 +31,83 @@ struct AnimationConfig {
  *          animation should derive from this class and implement the
  *          virtual methods.
  */
-#include "libs/RAMP/Ramp.h"
+#include "libs/RAMP/RampFixed.h"
 #include "libs/RAMP/RampCRGB.h"
 
+/**
+ * @brief Phase accumulator that counts animation steps without losing time.
+ * @details A step lasts `period / divisor` ms, such as `speed / num_leds`.
+ *          The phase is kept in units of 1/divisor ms, so the part of a tick
+ *          left over after a step carries into the next one and the division
+ *          is exact at every ring size. When a tick ran long, `advance`
+ *          returns every step that fell inside it, so the animation catches
+ *          up instead of slowing down.
+ */
+class StepClock {
+  public:
+    void reset() { phase = 0; }
+
+    /**
+     * @brief Adds `dt` ms and returns the number of whole steps now due.
+     * @details A zero period steps once per call.
+     */
+    uint32_t advance(uint32_t dt, uint32_t period, uint32_t divisor = 1) {
+        if (period == 0) {
+            phase = 0;
+            return 1;
+        }
+        phase += dt * divisor;
+        if (phase < period) {
+            return 0;
+        }
+        uint32_t steps = phase / period;
+        phase -= steps * period;
+        return steps;
+    }
+
+    /**
+     * @brief How far into the next step the phase is, 0-255.
+     * @param period The period last passed to `advance`.
+     */
+    uint8_t fraction(uint32_t period) const {
+        uint32_t ph = phase;
+        while (period > 0xFFFFFF) {
+            period >>= 1;
+            ph >>= 1;
+        }
+        if (period == 0) {
+            return 0;
+        }
+        uint32_t f = (ph << 8) / period;
+        return f > 255 ? 255 : (uint8_t)f;
+    }
+
+  private:
+    uint32_t phase = 0;
+};
+
+#ifdef KLYSTRON_HOST_BUILD
+/**
+ * @brief Animations constructed and not yet destroyed (host build only).
+ * @details Controllers build animations in place, so a missed destructor
+ *          never shows up as a heap leak; harnesses compare this with the
+ *          number of controllers that have an animation instead.
+ */
+inline int g_live_animations = 0;
+#endif
+
 class Animation {
   public:
-    Animation() : color_ramp(CRGB::Black), speed_ramp(0), brightness_ramp(0) {}
-    virtual ~Animation() {}
+    Animation() : color_ramp(CRGB::Black), speed_ramp(0), brightness_ramp(0) {
+#ifdef KLYSTRON_HOST_BUILD
+        g_live_animations++;
+#endif
+    }
+    virtual ~Animation() {
+#ifdef KLYSTRON_HOST_BUILD
+        g_live_animations--;
+#endif
+    }
 
     virtual void start(const AnimationConfig &config) {
         this->config = config;
@@ -58,12 +129,12 @@ class Animation {
     }
 
     virtual void update(uint32_t dt) {
-        // The Ramp library uses millis(), so we don't need dt here.
-        // This is not ideal, but I will stick with it for now to avoid
-        // modifying the library too much.
-        color_ramp.update();
-        speed_ramp.update();
-        brightness_ramp.update();
+        // The ramps run on millis(), so we don't need dt here. Read it
+        // once and advance all three against the same time.
+        uint32_t now = millis();
+        color_ramp.update(now);
+        speed_ramp.update(now);
+        brightness_ramp.update(now);
     }
 
     virtual bool isDone() = 0;
@@ -71,8 +142,8 @@ class Animation {
   protected:
     AnimationConfig config;
     RampCRGB color_ramp;
-    rampFloat speed_ramp;
-    rampFloat brightness_ramp;
+    rampFixedUInt16 speed_ramp;
+    rampFixedByte brightness_ramp;
 };
 
 #endif // ANIMATION_H
@@ -0,0 +1,34 @@
+/**
+ * @file animation_clock.cpp
+ * @brief Shared timebase for the animation controllers.
+ * @details See `animation_clock.h`. Only one context runs the controllers
+ *          at a time (the pack timer ISR, or the LED core once it has taken
+ *          over), so the state needs no locking.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "animation_clock.h"
+#include "pico/time.h"
+
+static uint32_t last_us = 0;
+static uint32_t carry_us = 0;
+
+void animation_clock_reset(void) {
+    last_us = time_us_32();
+    carry_us = 0;
+}
+
+uint32_t animation_clock_tick(void) {
+    const uint32_t now = time_us_32();
+    uint32_t elapsed_us = (now - last_us) + carry_us;
+    last_us = now;
+    if (elapsed_us >= ANIMATION_CLOCK_MAX_MS * 1000u) {
+        carry_us = 0;
+        return ANIMATION_CLOCK_MAX_MS;
+    }
+    const uint32_t ms = elapsed_us / 1000u;
+    carry_us = elapsed_us - ms * 1000u;
+    return ms;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file animation_clock.h
+ * @brief Shared timebase for the animation controllers.
+ * @details The pack timer is meant to fire every `pack_isr_interval_ms`, but
+ *          a pass that overruns (a busy `show_leds`, a long state change on
+ *          the LED core, an ISR delayed by flash access) stretches the real
+ *          period. Passing the nominal interval to every controller would let
+ *          animations fall behind by whatever the ticks overran.
+ *
+ *          `animation_clock_tick()` instead reads the hardware timer once per
+ *          frame and returns the whole milliseconds that really passed since
+ *          the previous frame, carrying the microsecond remainder into the
+ *          next one so nothing is lost. Animations keep their own step phase
+ *          with carry (`StepClock` in `animation.h`), so a long tick is caught
+ *          up with several steps and speeds hold whatever the ISR costs.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef ANIMATION_CLOCK_H
+#define ANIMATION_CLOCK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Longest frame the clock reports, in milliseconds.
+ * @details A stall longer than this (a debugger halt, a blocking board test)
+ *          is reported as this much, so animations do not race through
+ *          seconds of catch-up afterwards.
+ */
+#define ANIMATION_CLOCK_MAX_MS 64
+
+/**
+ * @brief Starts counting from now; call before the first frame.
+ */
+void animation_clock_reset(void);
+
+/**
+ * @brief Milliseconds elapsed since the previous call or the reset.
+ * @details Call once per animation frame, from whichever context runs the
+ *          controllers.
+ */
+uint32_t animation_clock_tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ANIMATION_CLOCK_H
@@ -1,46 +1,169 @@
 #include "animation_controller.h"
 
-AnimationController::AnimationController() : currentAction(nullptr), currentAnimation(nullptr) {}
+AnimationController::AnimationController()
+    : queueHead(0), queuedCount(0), currentAction(nullptr), inAction(false),
+      currentAbandoned(false), currentAnimation(nullptr), overlayAnimation(nullptr),
+      overlayTarget(nullptr), overlayCount(0), overlayBlend(LAYER_BLEND_ALPHA),
+      overlayOpacity(0), blendedLeds(0), blendedOpacity(0), maskLeds(nullptr), maskCount(0),
+      maskActive(nullptr), timeScale(1u << 16), scaledCarry(0), requestedPlays(0),
+      speedPlays(UINT32_MAX), lastSpeed(0)
+#ifdef KLYSTRON_DUAL_CORE
+      , commandsPosted(0), commandsDone(0)
+#endif
+{}
 
 AnimationController::~AnimationController() {
-    stop();
+    stopNow();
 }
 
-void AnimationController::play(std::unique_ptr<Action> action) {
-    stop();
-    enqueue(std::move(action));
+void AnimationController::update(uint32_t dt) {
+    restoreBase();
+    if (currentAction) {
+        inAction = true;
+        bool done = currentAction->update(dt);
+        inAction = false;
+        if (done || currentAbandoned) {
+            finishCurrentAction();
+            startNextAction();
+        }
+    }
+    // Actions above run in real time; the animations run in scaled time.
+    const uint64_t scaled = (uint64_t)dt * timeScale.load(std::memory_order_relaxed) + scaledCarry;
+    scaledCarry = (uint32_t)(scaled & 0xFFFF);
+    dt = (uint32_t)(scaled >> 16);
+    if (currentAnimation) {
+        currentAnimation->update(dt);
+        if (currentAnimation->isDone()) {
+            destroyAnimation();
+        }
+    }
+    if (overlayAnimation) {
+        overlayAnimation->update(dt);
+        if (overlayAnimation->isDone()) {
+            destroyOverlay();
+        }
+    }
+    composite();
 }
 
-void AnimationController::play(std::unique_ptr<Animation> anim, const AnimationConfig& config) {
-    play(std::make_unique<PlayAnimationAction>(std::move(anim), config));
+/** @brief One pixel of `over` blended onto `base` with `mode`. */
+static inline CRGB blend_layer(LayerBlend mode, const CRGB& base, const CRGB& over,
+                               uint8_t opacity) {
+    switch (mode) {
+    case LAYER_BLEND_ADD:
+        return base + CRGB(over).nscale8(opacity);
+    case LAYER_BLEND_MAX:
+        return base | CRGB(over).nscale8(opacity);
+    case LAYER_BLEND_ALPHA:
+    default:
+        return CRGB::blend(base, over, opacity);
+    }
 }
 
-void AnimationController::enqueue(std::unique_ptr<Action> action) {
-    actionQueue.push(std::move(action));
-    if (!currentAction) {
-        startNextAction();
+void AnimationController::restoreBase() {
+    if (!blendedLeds) {
+        return;
     }
+    // A pixel that no longer holds the blend was written by someone else
+    // since; that write wins over the saved base. The overlay's pixels are
+    // unchanged since the blend, as it only runs after this.
+    CRGB* out = overlayTarget;
+    for (uint16_t i = 0; i < blendedLeds; i++) {
+        if (out[i] == blend_layer(overlayBlend, basePixels[i], overlayPixels[i], blendedOpacity)) {
+            out[i] = basePixels[i];
+        }
+    }
+    blendedLeds = 0;
 }
 
-void AnimationController::update(uint32_t dt) {
-    if (currentAction) {
-        if (currentAction->update(dt)) {
-            currentAction.reset();
-            startNextAction();
+void AnimationController::composite() {
+    uint16_t visible = UINT16_MAX;
+    if (maskLeds) {
+        visible = std::min<uint16_t>(*maskActive, maskCount);
+    }
+
+    uint8_t opacity = overlayAnimation ? overlayOpacity.update() : 0;
+    if (opacity) {
+        uint16_t n = overlayCount;
+        if (overlayTarget == maskLeds && visible < n) {
+            n = visible;
+        }
+        CRGB* out = overlayTarget;
+        // Each pixel is read once: saved as the base's, then blended over.
+        for (uint16_t i = 0; i < n; i++) {
+            basePixels[i] = out[i];
+            out[i] = blend_layer(overlayBlend, out[i], overlayPixels[i], opacity);
         }
+        blendedLeds = n;
+        blendedOpacity = opacity;
     }
-    if (currentAnimation) {
-        currentAnimation->update(dt);
-        if (currentAnimation->isDone()) {
-            currentAnimation.reset();
+
+    if (maskLeds) {
+        for (uint16_t i = visible; i < maskCount; i++) {
+            maskLeds[i] = CRGB::Black;
         }
     }
 }
 
 void AnimationController::stop() {
+#ifdef KLYSTRON_DUAL_CORE
+    if (led_core_defer()) {
+        post([this]() { stopNow(); });
+        return;
+    }
+#endif
+    stopNow();
+}
+
+void AnimationController::stopNow() {
     clearQueue();
-    currentAction.reset();
-    currentAnimation.reset();
+    // The strip keeps the base's last frame, without the overlay.
+    restoreBase();
+    destroyAnimation();
+    destroyOverlay();
+}
+
+void AnimationController::stopOverlay() {
+#ifdef KLYSTRON_DUAL_CORE
+    if (led_core_defer()) {
+        post([this]() { destroyOverlay(); });
+        return;
+    }
+#endif
+    destroyOverlay();
+}
+
+void AnimationController::setOverlayOpacity(uint8_t opacity, uint32_t duration, ramp_mode mode) {
+    led_core_call([=]() { overlayOpacity.go(opacity, duration, mode); });
+}
+
+void AnimationController::setMask(CRGB* leds, uint16_t num_leds,
+                                  const volatile uint8_t* active_leds) {
+    maskLeds = nullptr;
+    std::atomic_signal_fence(std::memory_order_release);
+    maskCount = num_leds;
+    maskActive = active_leds;
+    std::atomic_signal_fence(std::memory_order_release);
+    maskLeds = leds;
+}
+
+void AnimationController::setSpeed(uint16_t speed, uint32_t duration, ramp_mode mode) {
+    // The state machine reapplies the same speed on every pass; only a
+    // change, or a new animation since the last one, is worth applying.
+    if (duration == 0) {
+        if (speed == lastSpeed && speedPlays == requestedPlays) {
+            return;
+        }
+        lastSpeed = speed;
+        speedPlays = requestedPlays;
+    } else {
+        speedPlays = UINT32_MAX; // mid-ramp, so the next immediate call applies
+    }
+    modify([=](Animation& anim) { anim.setSpeed(speed, duration, mode); });
+}
+
+void AnimationController::setColor(CRGB color, uint32_t duration, ramp_mode mode) {
+    modify([=](Animation& anim) { anim.setColor(color, duration, mode); });
 }
 
 bool AnimationController::isRunning() const {
@@ -49,39 +172,73 @@ bool AnimationController::isRunning() const {
     // actions in the queue. This ensures higher-level code can wait
     // for animations like the powercell waterfall to complete before
     // proceeding.
-    return currentAction != nullptr || currentAnimation != nullptr || !actionQueue.empty();
+#ifdef KLYSTRON_DUAL_CORE
+    if (commandsPosted.load(std::memory_order_relaxed) !=
+        commandsDone.load(std::memory_order_acquire)) {
+        return true;
+    }
+#endif
+    return currentAction != nullptr || currentAnimation != nullptr || queuedCount != 0;
 }
 
 Animation* AnimationController::getCurrentAnimation() {
-    return currentAnimation.get();
+    return currentAnimation;
 }
 
-void AnimationController::setCurrentAnimation(std::unique_ptr<Animation> anim) {
-    currentAnimation = std::move(anim);
+Animation* AnimationController::getOverlayAnimation() {
+    return overlayAnimation;
 }
 
-void AnimationController::startNextAction() {
-    if (!actionQueue.empty()) {
-        currentAction = std::move(actionQueue.front());
-        actionQueue.pop();
-        currentAction->start(this);
+void AnimationController::destroyAnimation() {
+    Animation* anim = currentAnimation;
+    // Unpublish before tearing down, mirroring the order play() publishes in.
+    currentAnimation = nullptr;
+    std::atomic_signal_fence(std::memory_order_release);
+    if (anim) {
+        anim->~Animation();
     }
 }
 
-void AnimationController::clearQueue() {
-    while (!actionQueue.empty()) {
-        actionQueue.pop();
+void AnimationController::destroyOverlay() {
+    Animation* anim = overlayAnimation;
+    overlayAnimation = nullptr;
+    std::atomic_signal_fence(std::memory_order_release);
+    if (anim) {
+        anim->~Animation();
     }
 }
 
-// Implementation of PlayAnimationAction
-void PlayAnimationAction::start(AnimationController* controller) {
-    Action::start(controller);
-    controller->setCurrentAnimation(std::move(animation));
-    controller->getCurrentAnimation()->start(config);
+void AnimationController::startNextAction() {
+    while (!currentAction && queuedCount != 0) {
+        currentAction = actionQueue[queueHead];
+        inAction = true;
+        currentAction->start(this);
+        inAction = false;
+        if (currentAbandoned) {
+            finishCurrentAction();
+        }
+    }
+}
+
+void AnimationController::finishCurrentAction() {
+    currentAction->~Action();
+    currentAction = nullptr;
+    currentAbandoned = false;
+    queueHead = (queueHead + 1) % kActionQueueCapacity;
+    queuedCount--;
 }
 
-bool PlayAnimationAction::update(uint32_t dt) {
-    // This action is done in start()
-    return true;
+void AnimationController::clearQueue() {
+    // A running action that stopped its own controller is left in place and
+    // retired once it returns; everything behind it goes now.
+    size_t keep = (inAction && currentAction) ? 1 : 0;
+    while (queuedCount > keep) {
+        queuedCount--;
+        actionQueue[(queueHead + queuedCount) % kActionQueueCapacity]->~Action();
+    }
+    if (keep) {
+        currentAbandoned = true;
+    } else {
+        currentAction = nullptr;
+    }
 }
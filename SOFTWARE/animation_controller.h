@@ -2,32 +2,323 @@
 #define ANIMATION_CONTROLLER_H
 
 #include "animation.h"
+#include "animations.h"
 #include "action.h"
-#include <queue>
-#include <memory>
+#include "addressable_LED_support.h"
+#include "led_core.h"
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
 
+/**
+ * @brief How an overlay layer is combined with the pixels under it.
+ * @details Each mode scales the overlay by the layer's opacity first.
+ */
+enum LayerBlend : uint8_t {
+    LAYER_BLEND_ALPHA, ///< Mix from the base toward the overlay
+    LAYER_BLEND_ADD,   ///< Add the overlay to the base, saturating
+    LAYER_BLEND_MAX,   ///< Keep the brighter of the two in each channel
+};
+
+/**
+ * @brief Runs the animations and actions for one LED strip.
+ * @details A strip is drawn as a stack of up to three layers:
+ *          - the base animation, started with `play`, which draws straight
+ *            into the strip buffer as it always has;
+ *          - an optional overlay animation, started with `playOverlay`, which
+ *            draws into the controller's own buffer and is blended over the
+ *            base with a blend mode and a rampable opacity;
+ *          - an optional mask, set with `setMask`, that keeps every LED from
+ *            a live count on dark.
+ *
+ *          `update` composites the overlay and the mask into the strip buffer
+ *          in one pass after the animations have run. With no overlay, or an
+ *          overlay at zero opacity, nothing is blended, so a strip with only
+ *          a base animation costs what it did before layers existed. While an
+ *          overlay is blended the controller keeps the base's own pixels and
+ *          puts them back before the base runs again, or is replaced or
+ *          stopped, so animations that only redraw on their steps, or read
+ *          back what they drew, never see the overlay. A pixel written
+ *          straight into the strip buffer since the blend, such as a
+ *          `fill_solid` from the state machine, is left as written.
+ */
 class AnimationController {
 public:
+    /** @brief Actions that can be pending at once, including the running one. */
+    static constexpr size_t kActionQueueCapacity = 8;
+    /** @brief Bytes reserved per queued action: the largest in action.h. */
+    static constexpr size_t kActionSlotSize = std::max({
+        sizeof(WaitAction), sizeof(ChangeColorAction), sizeof(ChangeSpeedAction),
+        sizeof(CallbackAction)});
+    /** @brief Bytes reserved for the animation: the largest in animations.h. */
+    static constexpr size_t kAnimationSlotSize = kMaxAnimationSize;
+    /** @brief Pixels an overlay can cover: the longest strip. */
+    static constexpr size_t kLayerLeds = std::max({
+        NUM_LEDS_POWERCELL, NUM_LEDS_CYCLOTRON, NUM_LEDS_FUTURE});
+
     AnimationController();
     ~AnimationController();
 
-    void play(std::unique_ptr<Action> action);
-    void play(std::unique_ptr<Animation> anim, const AnimationConfig& config);
-    void enqueue(std::unique_ptr<Action> action);
+    /**
+     * @brief Stops the actions and the base animation and starts an
+     *        animation of type T as the new base.
+     * @details The animation is constructed in this controller's own storage
+     *          slot with `args` and started with `config`; no heap allocation
+     *          takes place. It only becomes visible to `update` once it has
+     *          been fully constructed and started, so a timer ISR that
+     *          interrupts `play` sees either no animation or the new one.
+     *          The overlay and the mask are left as they are.
+     *          In dual-core mode a call from core0 is queued for the LED core
+     *          with copies of `config` and `args` (see `led_core.h`).
+     */
+    template <typename T, typename... Args>
+    void play(const AnimationConfig& config, Args&&... args) {
+        static_assert(std::is_base_of<Animation, T>::value, "T must derive from Animation");
+        static_assert(sizeof(T) <= kAnimationSlotSize,
+                      "animation is larger than the slot; list it in kMaxAnimationSize");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "animation is over-aligned");
+        requestedPlays++;
+#ifdef KLYSTRON_DUAL_CORE
+        if (led_core_defer()) {
+            post([this, config, args...]() { playNow<T>(config, args...); });
+            return;
+        }
+#endif
+        playNow<T>(config, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Starts an animation of type T on the overlay layer.
+     * @details Replaces any overlay already playing and leaves the base
+     *          animation and the action queue alone. The animation draws
+     *          into the controller's layer buffer, cleared to black, instead
+     *          of `config.leds`; `update` blends that buffer over the first
+     *          `config.num_leds` pixels of `config.leds` (at most
+     *          `kLayerLeds`) with `blend` at `opacity`. Storage and
+     *          dual-core behaviour are as for `play`.
+     */
+    template <typename T, typename... Args>
+    void playOverlay(const AnimationConfig& config, LayerBlend blend, uint8_t opacity,
+                     Args&&... args) {
+        static_assert(std::is_base_of<Animation, T>::value, "T must derive from Animation");
+        static_assert(sizeof(T) <= kAnimationSlotSize,
+                      "animation is larger than the slot; list it in kMaxAnimationSize");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "animation is over-aligned");
+#ifdef KLYSTRON_DUAL_CORE
+        if (led_core_defer()) {
+            post([this, config, blend, opacity, args...]() {
+                playOverlayNow<T>(config, blend, opacity, args...);
+            });
+            return;
+        }
+#endif
+        playOverlayNow<T>(config, blend, opacity, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Constructs an action of type T in place at the back of the queue.
+     * @details No heap allocation takes place. If the queue is idle the
+     *          action starts immediately. In dual-core mode a call from core0
+     *          is queued for the LED core and always reports success; a full
+     *          action queue then drops the action there.
+     * @return false, and nothing is queued, if the queue is full.
+     */
+    template <typename T, typename... Args>
+    bool enqueue(Args&&... args) {
+        static_assert(std::is_base_of<Action, T>::value, "T must derive from Action");
+        static_assert(sizeof(T) <= kActionSlotSize, "action is larger than an action slot");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "action is over-aligned");
+#ifdef KLYSTRON_DUAL_CORE
+        if (led_core_defer()) {
+            post([this, args...]() { enqueueNow<T>(args...); });
+            return true;
+        }
+#endif
+        return enqueueNow<T>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Runs `fn(animation)` on the current animation, if there is one.
+     * @details Use this rather than `getCurrentAnimation()` to change a
+     *          running animation, so the change is made on the LED core and
+     *          lands after any `play` queued ahead of it.
+     */
+    template <typename F>
+    void modify(F fn) {
+        led_core_call([this, fn]() mutable {
+            if (currentAnimation) {
+                fn(*currentAnimation);
+            }
+        });
+    }
+
+    /**
+     * @brief Ramps the current animation's speed; see Animation::setSpeed.
+     * @details An immediate change to the speed already set, with no `play`
+     *          since, does nothing, so a caller may reapply a speed on every
+     *          pass without re-arming the animation's speed ramp.
+     */
+    void setSpeed(uint16_t speed, uint32_t duration = 0, ramp_mode mode = LINEAR);
+    /** @brief Ramps the current animation's color; see Animation::setColor. */
+    void setColor(CRGB color, uint32_t duration = 0, ramp_mode mode = LINEAR);
+
+    /**
+     * @brief Scales the time the animations see, in 16.16 fixed point.
+     * @details `1 << 16`, the default, runs them in real time; `2 << 16`
+     *          runs them twice as fast and 0 freezes them. Both layers are
+     *          scaled and actions keep real time. The fraction of a
+     *          millisecond left over is carried, so slow scales lose nothing.
+     *          Setting the scale is one word store, safe from either core
+     *          without going through the LED core's queue, and takes effect
+     *          on the next `update`.
+     */
+    void setTimeScale(uint32_t scale) { timeScale.store(scale, std::memory_order_relaxed); }
+    uint32_t getTimeScale() const { return timeScale.load(std::memory_order_relaxed); }
+
+    /** @brief Ramps the overlay's opacity; 0 hides it without stopping it. */
+    void setOverlayOpacity(uint8_t opacity, uint32_t duration = 0, ramp_mode mode = LINEAR);
+    /** @brief Stops the overlay animation, leaving the base and the mask. */
+    void stopOverlay();
+
+    /**
+     * @brief Sets the mask layer: `leds[*active_leds]` onward stay black.
+     * @details `*active_leds` is read on every `update`, so the mask follows
+     *          it without being set again; a count past `num_leds` masks
+     *          nothing. Pass null `leds` to remove the mask. Set it before the
+     *          pack timer starts, or from the LED core.
+     */
+    void setMask(CRGB* leds, uint16_t num_leds, const volatile uint8_t* active_leds);
+
+    /** @brief Runs the layers and actions for one tick, then composites them. */
     void update(uint32_t dt);
+    /** @brief Stops the actions and both animations; the mask stays. */
     void stop();
+    /**
+     * @brief Whether the base animation or an action is still running.
+     * @details The overlay does not count, so code waiting on a base
+     *          sequence is not held up by an endless overlay.
+     */
     bool isRunning() const;
 
     Animation* getCurrentAnimation();
-    void setCurrentAnimation(std::unique_ptr<Animation> anim);
+    Animation* getOverlayAnimation();
 
 private:
+    template <typename T, typename... Args>
+    void playNow(const AnimationConfig& config, Args&&... args) {
+        clearQueue();
+        // The new base starts from the old one's pixels, not the blend.
+        restoreBase();
+        destroyAnimation();
+        T* anim = new (animationSlot) T(std::forward<Args>(args)...);
+        anim->start(config);
+        std::atomic_signal_fence(std::memory_order_release);
+        currentAnimation = anim;
+    }
+
+    template <typename T, typename... Args>
+    void playOverlayNow(const AnimationConfig& config, LayerBlend blend, uint8_t opacity,
+                        Args&&... args) {
+        restoreBase();
+        destroyOverlay();
+        AnimationConfig layer = config;
+        layer.leds = overlayPixels;
+        layer.num_leds = std::min<int>(config.num_leds, kLayerLeds);
+        fill_solid(overlayPixels, kLayerLeds, CRGB::Black);
+        overlayTarget = config.leds;
+        overlayCount = layer.num_leds;
+        overlayBlend = blend;
+        overlayOpacity.go(opacity, 0);
+        T* anim = new (overlaySlot) T(std::forward<Args>(args)...);
+        anim->start(layer);
+        std::atomic_signal_fence(std::memory_order_release);
+        overlayAnimation = anim;
+    }
+
+    template <typename T, typename... Args>
+    bool enqueueNow(Args&&... args) {
+        if (queuedCount == kActionQueueCapacity) {
+            return false;
+        }
+        size_t slot = (queueHead + queuedCount) % kActionQueueCapacity;
+        actionQueue[slot] = new (actionSlots[slot]) T(std::forward<Args>(args)...);
+        queuedCount++;
+        if (!currentAction) {
+            startNextAction();
+        }
+        return true;
+    }
+
+    void stopNow();
     void startNextAction();
+    void finishCurrentAction();
     void clearQueue();
+    void destroyAnimation();
+    void destroyOverlay();
+    void restoreBase();
+    void composite();
+
+    // Ring of in-place actions. The running action, if any, stays in its
+    // slot at the head until it finishes, so nothing is ever moved.
+    alignas(std::max_align_t) unsigned char actionSlots[kActionQueueCapacity][kActionSlotSize];
+    Action* actionQueue[kActionQueueCapacity];
+    size_t queueHead;
+    size_t queuedCount;
+    Action* currentAction;
+    // Set while the running action's start() or update() is on the stack, so
+    // a callback that stops this controller does not destroy its own caller.
+    bool inAction;
+    bool currentAbandoned;
+
+    alignas(std::max_align_t) unsigned char animationSlot[kAnimationSlotSize];
+    // Points into animationSlot while an animation is live, otherwise null.
+    Animation* currentAnimation;
+
+    alignas(std::max_align_t) unsigned char overlaySlot[kAnimationSlotSize];
+    // Points into overlaySlot while an overlay is live, otherwise null.
+    Animation* overlayAnimation;
+    CRGB overlayPixels[kLayerLeds];
+    CRGB* overlayTarget;
+    uint16_t overlayCount;
+    LayerBlend overlayBlend;
+    rampFixedByte overlayOpacity;
+    // The base's own pixels under the last blend, put back before it runs
+    // again; blendedLeds is how many there are, 0 when nothing was blended.
+    CRGB basePixels[kLayerLeds];
+    uint16_t blendedLeds;
+    uint8_t blendedOpacity;
+
+    CRGB* maskLeds;
+    uint16_t maskCount;
+    const volatile uint8_t* maskActive;
+
+    std::atomic<uint32_t> timeScale;
+    // Scaled time not yet forwarded, in 1/65536 ms
+    uint32_t scaledCarry;
+
+    // The caller's view for setSpeed(): plays requested so far, and the last
+    // speed set and how many plays had been requested at the time.
+    uint32_t requestedPlays;
+    uint32_t speedPlays;
+    uint16_t lastSpeed;
+
+#ifdef KLYSTRON_DUAL_CORE
+    // Queues fn for the LED core and counts it until it has run there, so
+    // isRunning() on core0 already reports a play or enqueue still in flight.
+    template <typename F>
+    void post(F fn) {
+        commandsPosted.store(commandsPosted.load(std::memory_order_relaxed) + 1,
+                             std::memory_order_relaxed);
+        led_core_call([this, fn]() mutable {
+            fn();
+            commandsDone.store(commandsDone.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_release);
+        });
+    }
 
-    std::queue<std::unique_ptr<Action>> actionQueue;
-    std::unique_ptr<Action> currentAction;
-    std::unique_ptr<Animation> currentAnimation;
+    std::atomic<uint32_t> commandsPosted;   // written by core0 only
+    std::atomic<uint32_t> commandsDone;     // written by the LED core only
+#endif
 };
 
 #endif // ANIMATION_CONTROLLER_H
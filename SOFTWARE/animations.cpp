@@ -6,17 +6,6 @@
 #include "cyclotron_sequences.h"
 
 // --- Helper functions for cyclotron-specific animations ---
-// These are still needed for RotateAnimation and SlimeAnimation
-extern const uint8_t cyc_classic_pos[4][5];
-extern volatile uint8_t cyclotron_color_set_size;
-extern volatile CRGB cyclotron_color_set[5];
-
-static const uint8_t* get_classic_positions() {
-    if (g_cyclotron_led_count == 4) return cyc_classic_pos[0];
-    if (g_cyclotron_led_count == 24) return cyc_classic_pos[1];
-    if (g_cyclotron_led_count == 32) return cyc_classic_pos[2];
-    return cyc_classic_pos[3];
-}
 
 static void reset_classic_color_set(const CRGB& color) {
     cyclotron_color_set_size = 1;
@@ -30,6 +19,52 @@ static void reset_classic_color_set(const CRGB& color) {
     }
 }
 
+/**
+ * @brief LED index of every classic-cyclotron light on an N-LED ring.
+ * @details Entry [step][k] is the LED k - 2 places from the position of
+ *          rotation step `step`, wrapped around the ring. A colour set of up
+ *          to five LEDs is centred on the position, so it never reaches
+ *          further than two places either side.
+ */
+template <uint8_t N>
+static constexpr auto make_classic_ring_index() {
+    constexpr int row = (N == 4) ? 0 : (N == 24) ? 1 : (N == 32) ? 2 : 3;
+    struct Table {
+        uint8_t led[4][5];
+    } table{};
+    for (int step = 0; step < 4; step++) {
+        for (int k = 0; k < 5; k++) {
+            table.led[step][k] = (uint8_t)((cyc_classic_pos[row][step] - 1 + k - 2 + N) % N);
+        }
+    }
+    return table;
+}
+
+template <uint8_t N>
+static constexpr auto classic_ring_index = make_classic_ring_index<N>();
+
+void ClassicRingLights::start() {
+    set_size = cyclotron_color_set_size;
+    first_column = (uint8_t)(2 - (set_size >> 1));
+    for (int i = 0; i < set_size; i++) {
+        colors[i] = CRGB(cyclotron_color_set[i].r, cyclotron_color_set[i].g, cyclotron_color_set[i].b);
+    }
+    ring_size = 0;
+    trackRingSize();
+}
+
+void ClassicRingLights::trackRingSize() {
+    const uint8_t n = g_cyclotron_led_count;
+    if (n == ring_size) return;
+    ring_size = n;
+    switch (n) {
+    case 4: index = &classic_ring_index<4>.led; break;
+    case 24: index = &classic_ring_index<24>.led; break;
+    case 32: index = &classic_ring_index<32>.led; break;
+    default: index = &classic_ring_index<40>.led; break;
+    }
+}
+
 static void draw_cylon_eye(CRGB *leds, int num_leds, int center, const CRGB &color) {
     // Use FastLED's fill_solid for clearing to leverage optimized routines.
     fill_solid(leds, num_leds, CRGB::Black);
@@ -46,16 +81,15 @@ void ShiftRotateAnimation::start(const AnimationConfig& config) {
     for (int i = 0; i < config.num_leds; i++) {
         config.leds[i] = ((i % 4) == 0) ? color : CRGB::Black;
     }
-    time_since_last_update = 0;
-    step_time_ms = this->speed_ramp.getValue() / config.num_leds;
+    step_clock.reset();
+    step_period_ms = this->speed_ramp.getValue();
 }
 
 void ShiftRotateAnimation::update(uint32_t dt) {
     Animation::update(dt);
-    time_since_last_update += dt;
-    if (time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
-        offset = (offset + (config.clockwise ? 1 : 3)) & 0x3;
+    uint32_t steps = step_clock.advance(dt, step_period_ms, config.num_leds);
+    if (steps) {
+        offset = (offset + steps * (config.clockwise ? 1 : 3)) & 0x3;
         CRGB color = this->color_ramp.getValue();
         for (int i = 0; i < config.num_leds; i++) {
             config.leds[i] = (((i + offset) % 4) == 0) ? color : CRGB::Black;
@@ -69,36 +103,33 @@ void RotateFadeAnimation::start(const AnimationConfig& config) {
     if (this->config.steps == 0) this->config.steps = 1;
     if (this->config.fade_amount == 0) this->config.fade_amount = 1;
     reset_classic_color_set(this->color_ramp.getValue());
+    lights.start();
     this->rotation_index = 0;
     this->prev_rotation_index = 0;
     this->fade_value = 255;
     fill_solid(config.leds, config.num_leds, CRGB::Black);
-    const uint8_t* positions = get_classic_positions();
-    for (int i = 0; i < cyclotron_color_set_size; i++) {
-        uint16_t pos = positions[rotation_index] - 1;
-        config.leds[(pos + i + config.num_leds - (cyclotron_color_set_size >> 1)) % config.num_leds] = CRGB(cyclotron_color_set[i].r, cyclotron_color_set[i].g, cyclotron_color_set[i].b);
+    for (int i = 0; i < lights.count(); i++) {
+        config.leds[lights.led(rotation_index, i)] = lights.color(i);
     }
-    this->time_since_last_update = 0;
-    this->step_time_ms = (this->speed_ramp.getValue() / 4) / this->config.steps;
+    this->step_clock.reset();
+    this->step_period_ms = this->speed_ramp.getValue();
 }
 
 void RotateFadeAnimation::update(uint32_t dt) {
     Animation::update(dt);
-    time_since_last_update += dt;
-    if (time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
-        const uint8_t* positions = get_classic_positions();
-        uint16_t prev_pos = positions[prev_rotation_index] - 1;
-        uint16_t cur_pos = positions[rotation_index] - 1;
-        for (int i = 0; i < cyclotron_color_set_size; i++) {
-            CRGB base = CRGB(cyclotron_color_set[i].r, cyclotron_color_set[i].g, cyclotron_color_set[i].b);
-            CRGB in_col = base;
+    uint32_t steps = step_clock.advance(dt, step_period_ms, 4 * this->config.steps);
+    if (steps) {
+        lights.trackRingSize();
+    }
+    for (; steps; steps--) {
+        for (int i = 0; i < lights.count(); i++) {
+            CRGB in_col = lights.color(i);
             in_col.nscale8_video(fade_value);
-            config.leds[(cur_pos + i + config.num_leds - (cyclotron_color_set_size >> 1)) % config.num_leds] = in_col;
+            config.leds[lights.led(rotation_index, i)] = in_col;
 
-            CRGB out_col = base;
+            CRGB out_col = lights.color(i);
             out_col.nscale8_video(255 - fade_value);
-            config.leds[(prev_pos + i + config.num_leds - (cyclotron_color_set_size >> 1)) % config.num_leds] = out_col;
+            config.leds[lights.led(prev_rotation_index, i)] = out_col;
         }
         if (fade_value < 255) {
             uint16_t new_fade = fade_value + this->config.fade_amount;
@@ -106,7 +137,7 @@ void RotateFadeAnimation::update(uint32_t dt) {
         } else {
             fade_value = 0;
             prev_rotation_index = rotation_index;
-            rotation_index = (rotation_index + (this->config.clockwise ? 1 : 3)) % 4;
+            rotation_index = (rotation_index + (this->config.clockwise ? 1 : 3)) & 0x3;
         }
     }
 }
@@ -117,42 +148,40 @@ void SlimeAnimation::start(const AnimationConfig& config) {
     if (this->config.steps == 0) this->config.steps = 1;
     if (this->config.fade_amount == 0) this->config.fade_amount = 1;
     reset_classic_color_set(this->color_ramp.getValue());
+    lights.start();
     this->rotation_index = 0;
     this->sub_seq1 = 0;
     this->fade_value = 0;
     fill_solid(config.leds, config.num_leds, CRGB::Black);
-    const uint8_t* positions = get_classic_positions();
     for (int j = 0; j < 4; j++) {
-        for (int i = 0; i < cyclotron_color_set_size; i++) {
-            uint16_t pos = positions[j] - 1;
-            config.leds[(pos + i + config.num_leds - (cyclotron_color_set_size >> 1)) % config.num_leds] = CRGB(cyclotron_color_set[i].r, cyclotron_color_set[i].g, cyclotron_color_set[i].b);
+        for (int i = 0; i < lights.count(); i++) {
+            config.leds[lights.led(j, i)] = lights.color(i);
         }
     }
-    this->time_since_last_update = 0;
-    this->step_time_ms = (this->speed_ramp.getValue() / 4) / this->config.steps;
+    this->step_clock.reset();
+    this->step_period_ms = this->speed_ramp.getValue();
 }
 
 void SlimeAnimation::update(uint32_t dt) {
     Animation::update(dt);
-    time_since_last_update += dt;
-    if (time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
-        const uint8_t* positions = get_classic_positions();
+    uint32_t steps = step_clock.advance(dt, step_period_ms, 4 * this->config.steps);
+    if (steps) {
+        lights.trackRingSize();
+    }
+    for (; steps; steps--) {
         sub_seq1++;
         if (fade_value < 255) fade_value += this->config.fade_amount;
         if (fade_value >= 255) fade_value = 255;
-        for (int i = 0; i < cyclotron_color_set_size; i++) {
-            uint16_t pos = positions[rotation_index] - 1;
-            config.leds[(pos + i + config.num_leds - (cyclotron_color_set_size >> 1)) % config.num_leds].nscale8(255 - fade_value);
+        for (int i = 0; i < lights.count(); i++) {
+            config.leds[lights.led(rotation_index, i)].nscale8(255 - fade_value);
         }
         if (sub_seq1 >= this->config.steps) {
             fade_value = 0;
             sub_seq1 = 0;
-            uint16_t prev_pos = positions[rotation_index] - 1;
-            for (int i = 0; i < cyclotron_color_set_size; i++) {
-                config.leds[(prev_pos + i + config.num_leds - (cyclotron_color_set_size >> 1)) % config.num_leds] = CRGB(cyclotron_color_set[i].r, cyclotron_color_set[i].g, cyclotron_color_set[i].b);
+            for (int i = 0; i < lights.count(); i++) {
+                config.leds[lights.led(rotation_index, i)] = lights.color(i);
             }
-            rotation_index = (rotation_index + (this->config.clockwise ? 1 : 3)) % 4;
+            rotation_index = (rotation_index + (this->config.clockwise ? 1 : 3)) & 0x3;
         }
     }
 }
@@ -164,7 +193,6 @@ void CylonFadeOutAnimation::start(const AnimationConfig& config) {
     this->fade_value = 0;
     this->seq_num = 0;
     this->done = false;
-    this->time_since_last_update = 0;
 }
 
 void CylonFadeOutAnimation::update(uint32_t dt) {
@@ -193,15 +221,13 @@ void ScrollAnimation::start(const AnimationConfig& config) {
     Animation::start(config);
     fill_solid(config.leds, config.num_leds, CRGB::Black);
     this->seq_num = 0;
-    this->time_since_last_update = 0;
+    this->step_clock.reset();
 }
 
 void ScrollAnimation::update(uint32_t dt) {
     Animation::update(dt);
-    uint16_t step_time_ms = this->speed_ramp.getValue() / config.num_leds;
-    time_since_last_update += dt;
-    if (time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
+    uint32_t steps = step_clock.advance(dt, this->speed_ramp.getValue(), config.num_leds);
+    for (; steps; steps--) {
         if (seq_num == 0) fill_solid(config.leds, config.num_leds, CRGB::Black);
         config.leds[seq_num] = this->color_ramp.getValue();
         seq_num = (seq_num + 1) % config.num_leds;
@@ -214,16 +240,14 @@ void FillAnimation::start(const AnimationConfig& config) {
     fill_solid(config.leds, config.num_leds, CRGB::Black);
     this->seq_num = 0;
     this->done = false;
-    this->time_since_last_update = 0;
+    this->step_clock.reset();
 }
 
 void FillAnimation::update(uint32_t dt) {
     Animation::update(dt);
     if (done) return;
-    uint16_t step_time_ms = this->speed_ramp.getValue() / config.num_leds;
-    time_since_last_update += dt;
-    if (time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
+    uint32_t steps = step_clock.advance(dt, this->speed_ramp.getValue(), config.num_leds);
+    for (; steps && !done; steps--) {
         config.leds[seq_num] = this->color_ramp.getValue();
         seq_num++;
         if (seq_num >= config.num_leds) done = true;
@@ -235,16 +259,14 @@ void DrainAnimation::start(const AnimationConfig& config) {
     Animation::start(config);
     fill_solid(config.leds, config.num_leds, this->color_ramp.getValue());
     this->done = false;
-    this->time_since_last_update = 0;
+    this->step_clock.reset();
 }
 
 void DrainAnimation::update(uint32_t dt) {
     Animation::update(dt);
     if (done) return;
-    uint16_t step_time_ms = this->speed_ramp.getValue() / config.num_leds;
-    time_since_last_update += dt;
-    if (time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
+    uint32_t steps = step_clock.advance(dt, this->speed_ramp.getValue(), config.num_leds);
+    for (; steps && !done; steps--) {
         bool all_black = true;
         for (int i = 0; i < config.num_leds - 1; i++) {
             config.leds[i] = config.leds[i + 1];
@@ -258,16 +280,15 @@ bool DrainAnimation::isDone() { return done; }
 
 void StrobeAnimation::start(const AnimationConfig& config) {
     Animation::start(config);
-    this->time_since_last_update = 0;
+    this->step_clock.reset();
 }
 
 void StrobeAnimation::update(uint32_t dt) {
     Animation::update(dt);
-    uint16_t step_time_ms = this->speed_ramp.getValue() / 2;
-    time_since_last_update += dt;
-    if (time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
-        uint8_t offset = (config.leds[0] == CRGB::Black) ? 1 : 0;
+    uint32_t steps = step_clock.advance(dt, this->speed_ramp.getValue(), 2);
+    if (steps) {
+        // Every step swaps the lit and dark LEDs, so only an odd count does.
+        uint8_t offset = ((config.leds[0] == CRGB::Black) ? 1 : 0) ^ ((steps & 1) ? 0 : 1);
         for (int i = 0; i < config.num_leds; i++) {
             config.leds[i] = ((i + offset) % 2) ? this->color_ramp.getValue() : CRGB::Black;
         }
@@ -282,17 +303,15 @@ void WaterfallAnimation::start(const AnimationConfig& config) {
     this->seq_num = config.num_leds - 1;
     this->sub_seq_1 = 1;
     this->done = false;
-    this->time_since_last_update = 0;
+    this->step_clock.reset();
 }
 
 void WaterfallAnimation::update(uint32_t dt) {
     Animation::update(dt);
     if (done) return;
     const uint16_t total_steps = (config.num_leds * (config.num_leds + 1)) >> 1;
-    uint16_t step_time_ms = this->speed_ramp.getValue() / total_steps;
-    time_since_last_update += dt;
-    if (time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
+    uint32_t steps = step_clock.advance(dt, this->speed_ramp.getValue(), total_steps);
+    for (; steps && !done; steps--) {
         if (sub_seq_1 == 0) {
             config.leds[config.num_leds - 1] = this->color_ramp.getValue();
             if (seq_num == 0) done = true;
@@ -311,59 +330,116 @@ bool WaterfallAnimation::isDone() { return done; }
 
 void CylonAnimation::start(const AnimationConfig& config) {
     Animation::start(config);
-    position = 0;
-    direction = 1;
-    time_since_last_update = 0;
-    draw_cylon_eye(config.leds, config.num_leds, position, this->color_ramp.getValue());
+    travel = 0;
+    step_clock.reset();
+    draw_cylon_eye(config.leds, config.num_leds, ledAt(travel), this->color_ramp.getValue());
+}
+
+uint8_t CylonAnimation::cycleLength() const {
+    if (config.bounce && config.num_leds > 1) return 2 * (config.num_leds - 1);
+    return config.num_leds;
+}
+
+uint8_t CylonAnimation::ledAt(uint8_t distance) const {
+    // Past the far end a bouncing eye is on its way back.
+    if (config.bounce && config.num_leds > 1 && distance >= config.num_leds - 1) {
+        return 2 * (config.num_leds - 1) - distance;
+    }
+    return distance;
 }
 
 void CylonAnimation::update(uint32_t dt) {
     Animation::update(dt);
-    time_since_last_update += dt;
-    if (time_since_last_update < this->speed_ramp.getValue()) return;
-    time_since_last_update = 0;
-    if (config.bounce && config.num_leds > 1) {
-        position += direction;
-        if (position >= config.num_leds - 1 || position <= 0) direction = -direction;
-    } else if (config.num_leds > 0) {
-        position = (position + 1) % config.num_leds;
+    const uint16_t speed = this->speed_ramp.getValue();
+    uint32_t steps = step_clock.advance(dt, speed);
+    if (!steps && !config.motion_blur) return;
+    const uint8_t cycle = cycleLength();
+    if (cycle == 0) return;
+    travel = (travel + steps) % cycle;
+
+    if (config.motion_blur) {
+        drawBlurred(step_clock.fraction(speed), speed ? dt / speed : 0);
+    } else {
+        draw_cylon_eye(config.leds, config.num_leds, ledAt(travel), this->color_ramp.getValue());
     }
+}
+
+void CylonAnimation::drawBlurred(uint8_t fraction, uint32_t trail) {
+    const uint8_t cycle = cycleLength();
+    const CRGB color = this->color_ramp.getValue();
+    if (trail > kMaxTrail) trail = kMaxTrail;
+    if (trail >= cycle) trail = cycle - 1;
+    fill_solid(config.leds, config.num_leds, CRGB::Black);
 
-    draw_cylon_eye(config.leds, config.num_leds, position, this->color_ramp.getValue());
+    // The eye sits `fraction`/256 of the way to the next LED. Light falls
+    // off linearly behind it over the trail, and the next LED gets the
+    // share the eye has already moved onto it.
+    const uint32_t length = (trail + 1) << 8;
+    for (uint32_t k = 0; k <= trail; k++) {
+        const uint32_t behind = fraction + (k << 8);
+        CRGB c = color;
+        c.nscale8_video((uint8_t)(255 * (length - behind) / length));
+        config.leds[ledAt((travel + cycle - k) % cycle)] |= c;
+    }
+    CRGB lead = color;
+    lead.nscale8_video(fraction);
+    config.leds[ledAt((travel + 1) % cycle)] |= lead;
 }
 bool CylonAnimation::isDone() { return false; }
 
 void RotateAnimation::start(const AnimationConfig& config) {
     Animation::start(config);
     reset_classic_color_set(this->color_ramp.getValue());
+    lights.start();
     this->rotation_index = 0;
     fill_solid(config.leds, config.num_leds, CRGB::Black);
-    this->time_since_last_update = 0;
+    this->step_clock.reset();
 }
 
 void RotateAnimation::update(uint32_t dt) {
     Animation::update(dt);
-    uint16_t step_time_ms = this->speed_ramp.getValue() / 4;
-    time_since_last_update += dt;
-
-    if (step_time_ms != 0 && time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
-        const uint8_t* positions = get_classic_positions();
+    uint16_t speed = this->speed_ramp.getValue();
+    uint32_t steps = (speed >= 4) ? step_clock.advance(dt, speed, 4) : 0;
+    const uint8_t turn = this->config.clockwise ? 1 : 3;
+
+    if (config.motion_blur) {
+        // Only the current and the next position can be lit.
+        const uint8_t next = (rotation_index + turn) & 0x3;
+        for (int i = 0; i < lights.count(); i++) {
+            config.leds[lights.led(rotation_index, i)] = CRGB::Black;
+            config.leds[lights.led(next, i)] = CRGB::Black;
+        }
+        lights.trackRingSize();
+        rotation_index = (rotation_index + steps * turn) & 0x3;
+        drawBlurred(step_clock.fraction(speed));
+    } else if (steps) {
+        lights.trackRingSize();
         CRGB color = this->color_ramp.getValue();
 
-        for (int i = 0; i < cyclotron_color_set_size; i++) {
-            uint16_t pos = positions[rotation_index] - 1;
-            config.leds[(pos + i + config.num_leds - (cyclotron_color_set_size >> 1)) % config.num_leds] = CRGB::Black;
+        for (int i = 0; i < lights.count(); i++) {
+            config.leds[lights.led(rotation_index, i)] = CRGB::Black;
         }
 
-        rotation_index = (rotation_index + (this->config.clockwise ? 1 : 3)) % 4;
+        rotation_index = (rotation_index + steps * turn) & 0x3;
 
-        for (int i = 0; i < cyclotron_color_set_size; i++) {
-            uint16_t pos = positions[rotation_index] - 1;
-            config.leds[(pos + i + config.num_leds - (cyclotron_color_set_size >> 1)) % config.num_leds] = color;
+        for (int i = 0; i < lights.count(); i++) {
+            config.leds[lights.led(rotation_index, i)] = color;
         }
     }
 }
+
+void RotateAnimation::drawBlurred(uint8_t fraction) {
+    const uint8_t next = (rotation_index + (this->config.clockwise ? 1 : 3)) & 0x3;
+    const CRGB color = this->color_ramp.getValue();
+    CRGB out_col = color;
+    out_col.nscale8_video(255 - fraction);
+    CRGB in_col = color;
+    in_col.nscale8_video(fraction);
+    for (int i = 0; i < lights.count(); i++) {
+        config.leds[lights.led(rotation_index, i)] |= out_col;
+        config.leds[lights.led(next, i)] |= in_col;
+    }
+}
 bool RotateAnimation::isDone() { return false; }
 
 void FadeAnimation::start(const AnimationConfig& config) {
@@ -372,17 +448,16 @@ void FadeAnimation::start(const AnimationConfig& config) {
     this->done = false;
     if (fade_out) fill_solid(config.leds, config.num_leds, this->color_ramp.getValue());
     else fill_solid(config.leds, config.num_leds, CRGB::Black);
-    this->time_since_last_update = 0;
+    this->step_clock.reset();
 }
 
 void FadeAnimation::update(uint32_t dt) {
     Animation::update(dt);
     if (done) return;
-    uint16_t step_time_ms = this->speed_ramp.getValue() / 256;
-    time_since_last_update += dt;
-    if (time_since_last_update >= step_time_ms) {
-        time_since_last_update = 0;
-        if (fade_value < 255) fade_value += 1;
+    uint32_t steps = step_clock.advance(dt, this->speed_ramp.getValue(), 256);
+    if (steps) {
+        // The step after reaching 255 is the one that finishes the fade.
+        if (fade_value + steps <= 255) fade_value += steps;
         else { fade_value = 255; done = true; }
         uint8_t scale = fade_out ? 255 - fade_value : fade_value;
         CRGB color = this->color_ramp.getValue();
@@ -394,6 +469,17 @@ void FadeAnimation::update(uint32_t dt) {
 }
 bool FadeAnimation::isDone() { return done; }
 
+void SolidAnimation::start(const AnimationConfig& config) {
+    Animation::start(config);
+    fill_solid(config.leds, config.num_leds, this->color_ramp.getValue());
+}
+
+void SolidAnimation::update(uint32_t dt) {
+    Animation::update(dt);
+    fill_solid(config.leds, config.num_leds, this->color_ramp.getValue());
+}
+bool SolidAnimation::isDone() { return false; }
+
 // --- Feedback Animations ---
 
 void FeedbackRainbowAnimation::start(const AnimationConfig& config) {
@@ -2,6 +2,8 @@
 #define ANIMATIONS_H
 
 #include "animation.h"
+#include <algorithm>
+#include <stddef.h>
 #include "party_sequences.h"
 
 /**
@@ -61,22 +63,53 @@ public:
     void update(uint32_t dt) override;
     bool isDone() override;
 private:
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
+    uint16_t step_period_ms = 0;
     uint8_t offset = 0;
 };
 
+/**
+ * @brief The cyclotron colour set and where it lands at each rotation step.
+ * @details Shared by the classic-cyclotron animations. `start()` copies the
+ *          colour set and picks the index table for the current ring size,
+ *          one of four built at compile time from `cyc_classic_pos`, so
+ *          drawing a step is table lookups only: no `%`, which the M0+ runs
+ *          in software, and no reads of the volatile colour set. The table is
+ *          picked again when ADJ1 changes the ring size mid-animation.
+ */
+class ClassicRingLights {
+public:
+    /** @brief Copies the colour set and picks the table for the ring size. */
+    void start();
+    /** @brief Picks the table again if the ring size has changed. */
+    void trackRingSize();
+    /** @brief Number of LEDs in the colour set. */
+    uint8_t count() const { return set_size; }
+    /** @brief LED that colour set entry `i` lights at rotation step `step`. */
+    uint8_t led(uint8_t step, uint8_t i) const { return (*index)[step][i + first_column]; }
+    /** @brief Colour of colour set entry `i`, as it was at `start()`. */
+    const CRGB& color(uint8_t i) const { return colors[i]; }
+
+private:
+    const uint8_t (*index)[4][5] = nullptr;
+    CRGB colors[5];
+    uint8_t set_size = 0;
+    uint8_t first_column = 0;
+    uint8_t ring_size = 0;
+};
+
 class RotateFadeAnimation : public Animation {
 public:
     void start(const AnimationConfig& config) override;
     void update(uint32_t dt) override;
     bool isDone() override;
 private:
+    ClassicRingLights lights;
     uint8_t rotation_index = 0;
     uint8_t prev_rotation_index = 0;
     uint16_t fade_value = 255;
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
+    uint16_t step_period_ms = 0;
 };
 
 class SlimeAnimation : public Animation {
@@ -85,11 +118,12 @@ public:
     void update(uint32_t dt) override;
     bool isDone() override;
 private:
+    ClassicRingLights lights;
     uint8_t rotation_index = 0;
     uint16_t sub_seq1 = 0;
     uint16_t fade_value = 0;
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
+    uint16_t step_period_ms = 0;
 };
 
 class CylonFadeOutAnimation : public Animation {
@@ -102,7 +136,6 @@ private:
     uint16_t fade_value = 0;
     uint8_t seq_num = 0;
     bool done = false;
-    uint32_t time_since_last_update = 0;
 };
 
 class ScrollAnimation : public Animation {
@@ -112,8 +145,7 @@ public:
     bool isDone() override;
 private:
     uint8_t seq_num = 0;
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
 };
 
 class FillAnimation : public Animation {
@@ -124,8 +156,7 @@ public:
 private:
     uint8_t seq_num = 0;
     bool done = false;
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
 };
 
 class DrainAnimation : public Animation {
@@ -135,8 +166,7 @@ public:
     bool isDone() override;
 private:
     bool done = false;
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
 };
 
 class StrobeAnimation : public Animation {
@@ -145,8 +175,7 @@ public:
     void update(uint32_t dt) override;
     bool isDone() override;
 private:
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
 };
 
 class WaterfallAnimation : public Animation {
@@ -158,30 +187,52 @@ private:
     uint8_t seq_num = 0;
     uint8_t sub_seq_1 = 0;
     bool done = false;
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
 };
 
+/**
+ * @brief A single eye running round the strip, or back and forth with
+ *        `bounce`.
+ * @details However many LEDs the eye passed since the last update, it jumps
+ *          straight there, so its top speed is not tied to the tick rate.
+ *          With `motion_blur` the eye is drawn at its exact position between
+ *          two LEDs, with a trail as long as it travels per update.
+ */
 class CylonAnimation : public Animation {
 public:
+    /** @brief Longest trail drawn behind a blurred eye, in LEDs. */
+    static constexpr uint8_t kMaxTrail = 8;
+
     void start(const AnimationConfig& config) override;
     void update(uint32_t dt) override;
     bool isDone() override;
 private:
-    int8_t direction = 1;
-    uint8_t position = 0;
-    uint32_t time_since_last_update = 0;
+    uint8_t cycleLength() const;
+    uint8_t ledAt(uint8_t distance) const;
+    void drawBlurred(uint8_t fraction, uint32_t trail);
+
+    // Distance along the eye's path: round the ring, or there and back.
+    uint8_t travel = 0;
+    StepClock step_clock;
 };
 
+/**
+ * @brief Classic cyclotron rotation through its four positions.
+ * @details Jumps by every step due since the last update. With
+ *          `motion_blur` the lights cross-fade into the next position as
+ *          the step progresses instead of switching at once.
+ */
 class RotateAnimation : public Animation {
 public:
     void start(const AnimationConfig& config) override;
     void update(uint32_t dt) override;
     bool isDone() override;
 private:
+    void drawBlurred(uint8_t fraction);
+
+    ClassicRingLights lights;
     uint8_t rotation_index = 0;
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
 };
 
 class FadeAnimation : public Animation {
@@ -194,8 +245,46 @@ private:
     uint16_t fade_value = 0;
     bool fade_out;
     bool done = false;
-    uint32_t time_since_last_update = 0;
-    uint16_t step_time_ms = 0;
+    StepClock step_clock;
+};
+
+/**
+ * @brief The whole strip in one colour, following the colour ramp; never
+ *        finishes.
+ * @details Mostly an overlay: a tint over the base, or black at a rising
+ *          opacity to fade out whatever is under it.
+ */
+class SolidAnimation : public Animation {
+public:
+    void start(const AnimationConfig& config) override;
+    void update(uint32_t dt) override;
+    bool isDone() override;
 };
 
+/**
+ * @brief Size of the largest animation above.
+ * @details Each AnimationController reserves this much storage and builds
+ *          its animations in place, so a class added to this file must be
+ *          added here too. `AnimationController::play` refuses to compile
+ *          for anything that does not fit.
+ */
+static constexpr size_t kMaxAnimationSize = std::max({
+    sizeof(FeedbackRainbowAnimation),
+    sizeof(PartyRainbowFadeAnimation),
+    sizeof(PartyRandomSparkleAnimation),
+    sizeof(BeatMeterAnimation),
+    sizeof(ShiftRotateAnimation),
+    sizeof(RotateFadeAnimation),
+    sizeof(SlimeAnimation),
+    sizeof(CylonFadeOutAnimation),
+    sizeof(ScrollAnimation),
+    sizeof(FillAnimation),
+    sizeof(DrainAnimation),
+    sizeof(StrobeAnimation),
+    sizeof(WaterfallAnimation),
+    sizeof(CylonAnimation),
+    sizeof(RotateAnimation),
+    sizeof(FadeAnimation),
+    sizeof(SolidAnimation)});
+
 #endif // ANIMATIONS_H
@@ -22,10 +22,3 @@ volatile uint8_t cyclotron_seq_num = 0;
 volatile uint8_t cyclotron_color_set_size = 1;
 volatile CRGB cyclotron_color_set[5];
 volatile uint8_t g_cyclotron_led_count = NUM_LEDS_CYCLOTRON;
-
-const uint8_t cyc_classic_pos[4][5] = {
-    {  1,  2,  3,  4,  4}, // 4 lights only
-    {  4, 10, 14, 20, 24}, // 24 lights only
-    {  5, 13, 19, 27, 32}, // 32 lights only
-    {  6, 16, 24, 34, 40}  // 40 lights only
-};
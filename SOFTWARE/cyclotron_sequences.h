@@ -28,10 +28,21 @@ extern volatile uint8_t cyclotron_color_set_size;
 extern volatile CRGB cyclotron_color_set[5];
 extern volatile uint8_t g_cyclotron_led_count;
 
-extern const uint8_t cyc_classic_pos[4][5];
-
 #ifdef __cplusplus
 }
+
+/**
+ * @brief 1-based LED of each classic-cyclotron position, per ring size.
+ * @details Rows are the 4, 24, 32 and 40 LED rings. `constexpr` so the
+ *          animations can build their index tables at compile time.
+ */
+constexpr uint8_t cyc_classic_pos[4][5] = {
+    {  1,  2,  3,  4,  4}, // 4 lights only
+    {  4, 10, 14, 20, 24}, // 24 lights only
+    {  5, 13, 19, 27, 32}, // 32 lights only
+    {  6, 16, 24, 34, 40}  // 40 lights only
+};
+
 static inline uint32_t afterlife_target_speed_x() {
     return (static_cast<uint32_t>(g_cyclotron_led_count) * 125U) / 40U;
 }
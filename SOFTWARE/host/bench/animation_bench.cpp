@@ -0,0 +1,182 @@
+/**
+ * @file animation_bench.cpp
+ * @brief Microbenchmark of `Animation::update()` for every animation.
+ * @details Runs every case in `animation_cases.h` at N = 4, 24, 32 and 40
+ *          LEDs, exactly as the golden-frame test does, and reports the
+ *          cost of one `update()` call as a JSON document on stdout:
+ *
+ *          ```
+ *          {"benchmark": "animation_update", "ticks_per_episode": 500,
+ *           "episodes": 20, "results": [
+ *            {"case": "Rotate", "n": 24, "ns_per_update": 41.7,
+ *             "instructions_per_update": 212.4}, ...]}
+ *          ```
+ *
+ *          An episode restarts the case from a fresh clock and runs it for
+ *          `CASE_TICKS` ticks. The same loop without the `update()` call is
+ *          timed alongside and subtracted, so the clock and party-state
+ *          bookkeeping are not charged to the animation. `ns_per_update` is
+ *          the fastest of the episodes, which is the least noisy figure on a
+ *          shared CI runner. Instructions are counted with `perf_event_open`
+ *          in user space only and do not depend on the machine's load; they
+ *          are `null` where the kernel does not allow counting (containers
+ *          often do not).
+ *
+ *          Usage: `animation_bench [--episodes E] [case...]`
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "animation_cases.h"
+
+/** @brief Episodes run per case and size unless `--episodes` says otherwise. */
+static const int BENCH_EPISODES = 20;
+
+/** @brief User-space instruction counter for this thread; -1 if unavailable. */
+class InstructionCounter {
+public:
+    InstructionCounter() {
+#ifdef __linux__
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~InstructionCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /** @brief Instructions since `start()`. */
+    long long stop() {
+        long long count = 0;
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof(count)) != (ssize_t)sizeof(count)) {
+                count = 0;
+            }
+        }
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+/** @brief Cost of one episode: wall time and instructions. */
+struct EpisodeCost {
+    double ns;
+    long long instructions;
+};
+
+/** @brief Runs one episode, with or without the `update()` calls. */
+static EpisodeCost run_episode(const AnimationCase &c, int n, bool update,
+                               InstructionCounter &counter) {
+    AnimationCaseRun run(c, n);
+    counter.start();
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < CASE_TICKS; tick++) {
+        const uint32_t dt = run.tick_ms(tick);
+        run.before_tick(tick);
+        host_clock_advance_us(dt * 1000);
+        if (update) {
+            run.anim->update(dt);
+        }
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    EpisodeCost cost;
+    cost.instructions = counter.stop();
+    cost.ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    return cost;
+}
+
+int main(int argc, char **argv) {
+    int episodes = BENCH_EPISODES;
+    std::vector<std::string> only;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--episodes") == 0 && i + 1 < argc) {
+            episodes = std::max(1, atoi(argv[++i]));
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [--episodes E] [case...]\n", argv[0]);
+            return 2;
+        } else {
+            only.push_back(argv[i]);
+        }
+    }
+
+    InstructionCounter counter;
+    std::vector<AnimationCase> cases = animation_cases();
+    printf("{\n  \"benchmark\": \"animation_update\",\n");
+    printf("  \"ticks_per_episode\": %d,\n  \"episodes\": %d,\n", CASE_TICKS, episodes);
+    printf("  \"results\": [");
+    bool first = true;
+    for (const AnimationCase &c : cases) {
+        if (!only.empty() && std::find(only.begin(), only.end(), c.name) == only.end()) {
+            continue;
+        }
+        for (int n : CASE_SIZES) {
+            double best_ns = 0;
+            long long instructions = 0;
+            for (int e = 0; e < episodes; e++) {
+                EpisodeCost with = run_episode(c, n, true, counter);
+                EpisodeCost without = run_episode(c, n, false, counter);
+                double ns = std::max(0.0, with.ns - without.ns);
+                if (e == 0 || ns < best_ns) {
+                    best_ns = ns;
+                }
+                // Deterministic; the last episode is as good as any.
+                instructions = with.instructions - without.instructions;
+            }
+            printf("%s\n    {\"case\": \"%s\", \"n\": %d, \"ns_per_update\": %.1f, ",
+                   first ? "" : ",", c.name, n, best_ns / CASE_TICKS);
+            if (counter.available()) {
+                printf("\"instructions_per_update\": %.1f}", (double)instructions / CASE_TICKS);
+            } else {
+                printf("\"instructions_per_update\": null}");
+            }
+            first = false;
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,212 @@
+/**
+ * @file pack_fuzzer.cpp
+ * @brief libFuzzer target for the pack state machine and switch debouncing.
+ * @details Each input is a stream of 3-byte records, one per held input
+ *          state:
+ *
+ *          | Byte | Bits | Meaning                                            |
+ *          |------|------|----------------------------------------------------|
+ *          | 0    | 0-4  | pack_pu, vent, song, fire, pu switches held on     |
+ *          | 0    | 5-7  | 1 sets `dip`, 2 `adj0`, 3 `adj1` from byte 1       |
+ *          | 1    |      | DIP value (low 5 bits) or pot value (top 8 bits)   |
+ *          | 2    | 0-5  | Pack timer ticks the state is held for, less one   |
+ *
+ *          The records are scheduled on the stub hardware's clock, so the
+ *          real ISR debounces them however the state machine loop happens
+ *          to be blocked. After the last record every switch is released
+ *          and the pack must come back to `PS_OFF`, which also leaves the
+ *          next input starting from a powered-down pack.
+ *
+ *          After every `pack_state_process()` pass the target aborts if:
+ *          - the pack is in a firing state with `pu_sw()` off, whether
+ *            or not fire is held, unless the wand went off while that
+ *            very pass was blocked, in which case the next pass must end
+ *            the shot;
+ *          - `g_cyclotron_led_count` is not a supported ring size;
+ *          - the number of live animations differs from the number the
+ *            controllers hold on either layer, so one was leaked or destroyed twice;
+ *          - the pass ran for more than `FUZZ_MAX_PASS_TICKS` ticks after
+ *            the last input change, which is a hang in a blocking loop.
+ *
+ *          Built with clang and `-DKLYSTRON_FUZZ=ON`; `pack_fuzz_replay`
+ *          runs the same checks over saved inputs with any compiler.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "host_clock.h"
+#include "input_script.h"
+#include "stub_hal.h"
+#include "animation.h"
+#include "klystron.h"
+#include "klystron_IO_support.h"
+#include "cyclotron_sequences.h"
+#include "pack_config.h"
+#include "pack_state.h"
+#include "party_sequences.h"
+
+/** @brief Simulated cost of a pass that neither sleeps nor spins. */
+static const uint64_t FUZZ_IDLE_PASS_US = 100;
+
+/** @brief Bytes per input record. */
+static const size_t FUZZ_RECORD_SIZE = 3;
+
+/** @brief Records past this are ignored, so one input stays short. */
+static const size_t FUZZ_MAX_RECORDS = 512;
+
+/** @brief Longest a pass may run once the inputs stop changing. */
+static const uint64_t FUZZ_MAX_PASS_TICKS = 2500;
+
+/** @brief Longest the pack may take to power down with every switch off. */
+static const uint64_t FUZZ_SETTLE_TICKS = 7500;
+
+static const char *const fuzz_switches[] = {"pack_pu", "vent", "song", "fire", "pu"};
+
+#define FUZZ_CHECK(cond, ...)                                   \
+    do {                                                        \
+        if (!(cond)) {                                          \
+            fprintf(stderr, "pack_fuzzer: %10.3f ms: ",         \
+                    host_clock_now_us() / 1000.0);              \
+            fprintf(stderr, __VA_ARGS__);                       \
+            fputc('\n', stderr);                                \
+            abort();                                            \
+        }                                                       \
+    } while (0)
+
+static uint64_t tick_us() { return (uint64_t)pack_isr_interval_ms * 1000; }
+
+static bool firing_state(PackState state) {
+    return state == PS_FIRE || state == PS_SLIME_FIRE || state == PS_OVERHEAT;
+}
+
+static int controller_animations() {
+    int count = 0;
+    for (AnimationController *c :
+         {&g_powercell_controller, &g_cyclotron_controller, &g_future_controller}) {
+        if (c->getCurrentAnimation()) {
+            count++;
+        }
+        if (c->getOverlayAnimation()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Runs one state machine pass and checks the invariants after it.
+ * @param changes When the inputs change, in order, for the hang check.
+ */
+static void fuzz_pass(const std::vector<uint64_t> &changes) {
+    const uint64_t before = host_clock_now_us();
+    const bool pu_before = pu_sw();
+    pack_state_process();
+    // Sampled before the idle advance below, which can run the ISR and
+    // change the switches after the pass has returned. A pass cannot see a
+    // switch that changed while it was blocked (fire_department(0) sleeps
+    // through the start sound's lead-in), so if the wand went off during
+    // the pass the firing state must be gone by the end of the next one.
+    const PackState state = pack_state_get_state();
+    FUZZ_CHECK(!(firing_state(state) && !pu_sw() && !pu_before),
+               "firing in state %d with pu_sw() off", (int)state);
+    uint64_t now = host_clock_now_us();
+    if (now == before) {
+        host_clock_advance_us(FUZZ_IDLE_PASS_US);
+        now = host_clock_now_us();
+    }
+
+    const uint8_t leds = g_cyclotron_led_count;
+    FUZZ_CHECK(leds == 4 || leds == 24 || leds == 32 || leds == 40,
+               "g_cyclotron_led_count is %u", (unsigned)leds);
+    FUZZ_CHECK(g_live_animations == controller_animations(),
+               "%d animations alive, controllers hold %d", g_live_animations,
+               controller_animations());
+    // A pass blocked across an input change is measured from that change.
+    auto change = std::upper_bound(changes.begin(), changes.end(), now);
+    uint64_t from = before;
+    if (change != changes.begin() && *(change - 1) > from) {
+        from = *(change - 1);
+    }
+    FUZZ_CHECK((now - from) / tick_us() <= FUZZ_MAX_PASS_TICKS,
+               "pass ran %llu ticks with the inputs unchanged",
+               (unsigned long long)((now - from) / tick_us()));
+}
+
+/**
+ * @brief Releases every input and runs until the pack is off.
+ */
+static void fuzz_settle() {
+    StubHal &hal = host_stub_hal();
+    const uint64_t start = host_clock_now_us();
+    std::vector<InputEvent> release;
+    for (const char *sw : fuzz_switches) {
+        release.push_back({start, sw, 0});
+    }
+    input_script_schedule(release, hal);
+
+    const uint64_t end = start + FUZZ_SETTLE_TICKS * tick_us();
+    while (pack_state_get_state() != PS_OFF) {
+        FUZZ_CHECK(host_clock_now_us() < end, "still in state %d with every switch off",
+                   (int)pack_state_get_state());
+        fuzz_pass({start});
+    }
+    if (party_mode_is_active()) {
+        party_mode_stop();
+    }
+}
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    (void)argc;
+    (void)argv;
+    klystron_init();
+    fuzz_settle();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    StubHal &hal = host_stub_hal();
+    uint64_t at = host_clock_now_us();
+    std::vector<InputEvent> events;
+    std::vector<uint64_t> changes;
+
+    size_t records = size / FUZZ_RECORD_SIZE;
+    if (records > FUZZ_MAX_RECORDS) {
+        records = FUZZ_MAX_RECORDS;
+    }
+    for (size_t r = 0; r < records; r++) {
+        const uint8_t *rec = data + r * FUZZ_RECORD_SIZE;
+        for (size_t s = 0; s < sizeof(fuzz_switches) / sizeof(fuzz_switches[0]); s++) {
+            events.push_back({at, fuzz_switches[s], (uint16_t)((rec[0] >> s) & 1)});
+        }
+        switch (rec[0] >> 5) {
+        case 1:
+            events.push_back({at, "dip", (uint16_t)(rec[1] & 0x1F)});
+            break;
+        case 2:
+        case 3:
+            events.push_back({at, (rec[0] >> 5) == 2 ? "adj0" : "adj1",
+                              (uint16_t)(rec[1] << 4 | rec[1] >> 4)});
+            break;
+        default:
+            break;
+        }
+        changes.push_back(at);
+        at += (uint64_t)(1 + (rec[2] & 0x3F)) * tick_us();
+    }
+    input_script_schedule(events, hal);
+
+    while (host_clock_now_us() < at) {
+        fuzz_pass(changes);
+    }
+    fuzz_settle();
+    return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file replay_main.cpp
+ * @brief Runs saved fuzzer inputs through `pack_fuzzer.cpp` without libFuzzer.
+ * @details Usage: `pack_fuzz_replay <file or directory>...`
+ *
+ *          Every file named, and every file in every directory named, is fed
+ *          to `LLVMFuzzerTestOneInput` in turn, in name order. An invariant
+ *          violation aborts with the file being run on stderr, so the seed
+ *          corpus doubles as a regression test and a crash found by the
+ *          fuzzer can be reproduced under a debugger with any compiler.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv);
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file or directory>...\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(argv[i], ec)) {
+            std::vector<std::string> dir;
+            for (const auto &entry : std::filesystem::directory_iterator(argv[i])) {
+                if (entry.is_regular_file()) {
+                    dir.push_back(entry.path().string());
+                }
+            }
+            std::sort(dir.begin(), dir.end());
+            files.insert(files.end(), dir.begin(), dir.end());
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    LLVMFuzzerInitialize(&argc, &argv);
+    for (const std::string &path : files) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            fprintf(stderr, "%s: cannot open\n", path.c_str());
+            return 1;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                                  std::istreambuf_iterator<char>());
+        fprintf(stderr, "running %s (%zu bytes)\n", path.c_str(), data.size());
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    printf("%zu inputs passed\n", files.size());
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file host_clock.cpp
+ * @brief Simulated time base for the host build.
+ * @details Implements the Pico SDK time API and the Arduino timing functions
+ *          on top of a single microsecond counter, plus the repeating timers
+ *          that stand in for the pack timer interrupt.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "host_clock.h"
+#include "pico/stdlib.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** @brief Upper bound on repeating timers; the firmware only arms one. */
+#define HOST_CLOCK_MAX_TIMERS 4
+
+/** @brief A registered repeating timer and when it next falls due. */
+typedef struct {
+    repeating_timer_t *timer;
+    uint64_t due_us;
+} HostTimer;
+
+static uint64_t s_now_us = 0;
+static HostTimer s_timers[HOST_CLOCK_MAX_TIMERS];
+static int s_timer_count = 0;
+static bool s_in_timer = false;
+
+extern "C" {
+
+uint64_t host_clock_now_us(void) { return s_now_us; }
+
+bool host_clock_in_timer(void) { return s_in_timer; }
+
+void host_clock_reset(void) {
+    s_now_us = 0;
+    s_timer_count = 0;
+    s_in_timer = false;
+}
+
+void host_clock_advance_us(uint64_t us) {
+    const uint64_t target = s_now_us + us;
+    if (s_in_timer) {
+        s_now_us = target;
+        return;
+    }
+    while (true) {
+        int next = -1;
+        for (int i = 0; i < s_timer_count; i++) {
+            if (s_timers[i].due_us <= target &&
+                (next < 0 || s_timers[i].due_us < s_timers[next].due_us)) {
+                next = i;
+            }
+        }
+        if (next < 0) {
+            break;
+        }
+        HostTimer *t = &s_timers[next];
+        if (t->due_us > s_now_us) {
+            s_now_us = t->due_us;
+        }
+        s_in_timer = true;
+        bool keep = t->timer->callback(t->timer);
+        s_in_timer = false;
+        if (keep) {
+            // Callbacks take no simulated time, so a positive delay (measured
+            // from the end of the callback) and a negative one (measured from
+            // the scheduled start) land on the same grid.
+            int64_t delay = t->timer->delay_us;
+            t->due_us = s_now_us + (uint64_t)(delay < 0 ? -delay : delay);
+        } else {
+            s_timers[next] = s_timers[--s_timer_count];
+        }
+    }
+    if (target > s_now_us) {
+        s_now_us = target;
+    }
+}
+
+// === Pico SDK time API ===
+
+absolute_time_t get_absolute_time(void) { return s_now_us; }
+
+uint32_t time_us_32(void) { return (uint32_t)s_now_us; }
+
+uint64_t time_us_64(void) { return s_now_us; }
+
+void sleep_us(uint64_t us) { host_clock_advance_us(us); }
+
+void sleep_ms(uint32_t ms) { host_clock_advance_us((uint64_t)ms * 1000); }
+
+void busy_wait_us(uint64_t us) { host_clock_advance_us(us); }
+
+void tight_loop_contents(void) { host_clock_advance_us(HOST_CLOCK_SPIN_STEP_US); }
+
+bool stdio_init_all(void) { return true; }
+
+void panic(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fputs("*** PANIC ***\n", stderr);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    abort();
+}
+
+bool add_repeating_timer_us(int64_t delay_us,
+                            repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+    if (s_timer_count >= HOST_CLOCK_MAX_TIMERS || delay_us == 0) {
+        return false;
+    }
+    out->delay_us = delay_us;
+    out->alarm_id = s_timer_count + 1;
+    out->callback = callback;
+    out->user_data = user_data;
+    s_timers[s_timer_count].timer = out;
+    s_timers[s_timer_count].due_us =
+        s_now_us + (uint64_t)(delay_us < 0 ? -delay_us : delay_us);
+    s_timer_count++;
+    return true;
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    for (int i = 0; i < s_timer_count; i++) {
+        if (s_timers[i].timer == timer) {
+            s_timers[i] = s_timers[--s_timer_count];
+            return true;
+        }
+    }
+    return false;
+}
+
+// === Arduino timing, shared with RAMP and FastLED's stub platform ===
+
+uint32_t millis(void) { return (uint32_t)(s_now_us / 1000); }
+
+uint32_t micros(void) { return (uint32_t)s_now_us; }
+
+void delay(int ms) {
+    if (ms > 0) {
+        sleep_ms((uint32_t)ms);
+    }
+}
+
+void yield(void) { tight_loop_contents(); }
+
+} // extern "C"
@@ -0,0 +1,54 @@
+/**
+ * @file host_clock.h
+ * @brief Simulated time base for the host build.
+ * @details The host build never reads the wall clock. Time only moves when
+ *          the firmware sleeps or spins, or when a harness advances it, and
+ *          every repeating timer that falls due on the way is run at its due
+ *          time. The same inputs therefore always produce the same output.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Amount `tight_loop_contents()` advances the clock by, in µs. */
+#define HOST_CLOCK_SPIN_STEP_US 10
+
+/**
+ * @brief Returns the current host time in microseconds since boot.
+ */
+uint64_t host_clock_now_us(void);
+
+/**
+ * @brief Advances the host clock, running any repeating timers that fall due.
+ * @details Timers run in due order with the clock set to their due time.
+ *          When called from inside a timer callback the clock moves but no
+ *          further timers are run, mirroring an ISR that cannot preempt
+ *          itself.
+ * @param us The number of microseconds to advance by.
+ */
+void host_clock_advance_us(uint64_t us);
+
+/**
+ * @brief Reports whether a repeating timer callback is currently running.
+ */
+bool host_clock_in_timer(void);
+
+/**
+ * @brief Rewinds the clock to zero and cancels every repeating timer.
+ */
+void host_clock_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_CLOCK_H
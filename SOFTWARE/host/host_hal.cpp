@@ -0,0 +1,74 @@
+/**
+ * @file host_hal.cpp
+ * @brief Forwards the host hardware stand-ins to the installed HAL.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "host_hal.h"
+#include "stub_hal.h"
+#include "hardware/adc.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+#include "fl/engine_events.h"
+
+static HostHal *s_hal = nullptr;
+static uint s_adc_input = 0;
+
+/**
+ * @brief Hands every completed `FastLED.show()` to the HAL.
+ * @details FastLED raises `onEndShowLeds` after pushing all controllers, so
+ *          listening here catches every frame without touching the firmware's
+ *          LED code.
+ */
+class HalShowListener : public fl::EngineEvents::Listener {
+public:
+    HalShowListener() { fl::EngineEvents::addListener(this); }
+    ~HalShowListener() { fl::EngineEvents::removeListener(this); }
+
+    /** @brief Reports every controller, in the order they were added. */
+    void onEndShowLeds() override {
+        HostLedStrip strips[HOST_HAL_MAX_STRIPS];
+        size_t count = 0;
+        for (CLEDController *c = CLEDController::head();
+             c && count < HOST_HAL_MAX_STRIPS; c = c->next()) {
+            strips[count].leds = c->leds();
+            strips[count].num_leds = (uint16_t)c->size();
+            count++;
+        }
+        host_hal().showLeds(strips, count, FastLED.getBrightness());
+    }
+};
+
+void host_hal_set(HostHal *hal) { s_hal = hal; }
+
+HostHal &host_hal() {
+    static HalShowListener listener;
+    return s_hal ? *s_hal : host_stub_hal();
+}
+
+extern "C" {
+
+// Never dereferenced; the HAL has a single sound UART.
+uart_inst_t *const host_uart0 = nullptr;
+
+bool gpio_get(uint gpio) { return host_hal().gpioGet(gpio); }
+
+void gpio_put(uint gpio, bool value) { host_hal().gpioPut(gpio, value); }
+
+void adc_select_input(uint input) { s_adc_input = input; }
+
+uint16_t adc_read(void) { return host_hal().adcRead(s_adc_input) & 0x0FFF; }
+
+void uart_putc_raw(uart_inst_t *uart, char c) {
+    (void)uart;
+    host_hal().uartPutc((uint8_t)c);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+} // extern "C"
@@ -0,0 +1,70 @@
+/**
+ * @file host_hal.h
+ * @brief Hardware abstraction layer for the host build.
+ * @details The host stand-ins for `gpio_get`, `gpio_put`, `adc_read` and
+ *          `uart_putc_raw`, and every `FastLED.show()`, are forwarded to the
+ *          `HostHal` installed here. A harness that wants to drive inputs or
+ *          capture output installs its own implementation; otherwise the
+ *          default `StubHal` (see `stub_hal.h`) is used.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <FastLED.h>
+
+/** @brief Upper bound on strips reported per frame. */
+#define HOST_HAL_MAX_STRIPS 8
+
+/** @brief One LED strip as handed to `HostHal::showLeds`. */
+struct HostLedStrip {
+    const CRGB *leds;  /**< Pixel data before global brightness is applied. */
+    uint16_t num_leds; /**< Number of pixels in `leds`. */
+};
+
+/**
+ * @brief The hardware the firmware core talks to on the host.
+ */
+class HostHal {
+public:
+    virtual ~HostHal() {}
+
+    /** @brief Returns the input level of a GPIO pin. */
+    virtual bool gpioGet(unsigned pin) = 0;
+
+    /** @brief Drives an output GPIO pin. */
+    virtual void gpioPut(unsigned pin, bool value) = 0;
+
+    /** @brief Returns a 12-bit conversion of an ADC input. */
+    virtual uint16_t adcRead(unsigned input) = 0;
+
+    /** @brief Transmits one byte to the sound module. */
+    virtual void uartPutc(uint8_t c) = 0;
+
+    /**
+     * @brief Receives a frame each time `FastLED.show()` completes.
+     * @param strips Every registered strip, in the order they were added.
+     * @param count The number of entries in `strips`.
+     * @param brightness The global brightness the frame was shown at.
+     */
+    virtual void showLeds(const HostLedStrip *strips, size_t count,
+                          uint8_t brightness) = 0;
+};
+
+/**
+ * @brief Installs the HAL the host stand-ins forward to.
+ * @param hal The implementation to use, or `nullptr` for the default stub.
+ */
+void host_hal_set(HostHal *hal);
+
+/**
+ * @brief Returns the HAL currently installed.
+ */
+HostHal &host_hal();
+
+#endif // HOST_HAL_H
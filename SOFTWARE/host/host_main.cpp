@@ -0,0 +1,67 @@
+/**
+ * @file host_main.cpp
+ * @brief Entry point for the host build of the firmware.
+ * @details Runs the same start-up sequence and state machine loop as the
+ *          RP2040 `main`, against the default stub hardware, for a fixed
+ *          amount of simulated time.
+ *
+ *          Usage: `klystron_host [duration_ms] [--trace]`
+ *
+ *          `--trace` logs every sound command the firmware sends. When built
+ *          with `-DKLYSTRON_ISR_PROFILE=ON` the ISR stage table is printed on
+ *          exit.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_clock.h"
+#include "stub_hal.h"
+#include "klystron.h"
+#include "pack_state.h"
+#include "isr_profiler.h"
+
+/**
+ * @brief Simulated cost of a state machine pass that neither sleeps nor spins.
+ * @details Without it a state that only polls would never let time move.
+ */
+static const uint64_t HOST_IDLE_PASS_US = 100;
+
+int main(int argc, char **argv) {
+    uint32_t duration_ms = 10000;
+    bool trace = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0) {
+            trace = true;
+        } else {
+            duration_ms = (uint32_t)strtoul(argv[i], nullptr, 10);
+        }
+    }
+
+    StubHal &hal = host_stub_hal();
+    hal.setTrace(trace ? stdout : nullptr);
+
+    klystron_init();
+
+    const uint64_t end_us = (uint64_t)duration_ms * 1000;
+    while (host_clock_now_us() < end_us) {
+        const uint64_t before = host_clock_now_us();
+        pack_state_process();
+        if (host_clock_now_us() == before) {
+            host_clock_advance_us(HOST_IDLE_PASS_US);
+        }
+    }
+
+    printf("ran %u ms: %u frames shown, pack state %d\n",
+           (unsigned)(host_clock_now_us() / 1000), (unsigned)hal.framesShown(),
+           (int)pack_state_get_state());
+#ifdef KLYSTRON_ISR_PROFILE
+    isr_profile_dump();
+#endif
+    return 0;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file hardware/adc.h
+ * @brief Host stand-in for the Pico SDK ADC API.
+ * @details Conversions are forwarded to the active `HostHal` for whichever
+ *          input was last selected.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_HARDWARE_ADC_H
+#define HOST_HARDWARE_ADC_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+
+static inline void adc_init(void) {}
+static inline void adc_gpio_init(uint gpio) { (void)gpio; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_HARDWARE_ADC_H
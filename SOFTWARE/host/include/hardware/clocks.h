@@ -0,0 +1,20 @@
+/**
+ * @file hardware/clocks.h
+ * @brief Host stand-in for the Pico SDK clocks API.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_HARDWARE_CLOCKS_H
+#define HOST_HARDWARE_CLOCKS_H
+
+#include "pico/types.h"
+
+/** @brief The RP2040's default system clock, reported for code that asks. */
+static inline uint32_t clock_get_hz(int clk_index) {
+    (void)clk_index;
+    return 125000000u;
+}
+
+#endif // HOST_HARDWARE_CLOCKS_H
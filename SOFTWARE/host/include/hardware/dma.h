@@ -0,0 +1,28 @@
+/**
+ * @file hardware/dma.h
+ * @brief Host stand-in for the Pico SDK DMA API.
+ * @details The host has no DMA; FastLED's stub platform claims no channels, so
+ *          LED output is synchronous and no completion is ever pending.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_HARDWARE_DMA_H
+#define HOST_HARDWARE_DMA_H
+
+#include "pico/types.h"
+
+#define NUM_DMA_CHANNELS 12
+
+static inline bool dma_channel_is_claimed(uint channel) {
+    (void)channel;
+    return false;
+}
+
+static inline bool dma_channel_get_irq0_status(uint channel) {
+    (void)channel;
+    return false;
+}
+
+#endif // HOST_HARDWARE_DMA_H
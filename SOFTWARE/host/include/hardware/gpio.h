@@ -0,0 +1,43 @@
+/**
+ * @file hardware/gpio.h
+ * @brief Host stand-in for the Pico SDK GPIO API.
+ * @details Pin reads and writes are forwarded to the active `HostHal`.
+ *          Configuration calls are accepted and ignored.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+#include "pico/types.h"
+
+#define GPIO_IN 0
+#define GPIO_OUT 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum gpio_function {
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_NULL = 0x1f,
+};
+
+bool gpio_get(uint gpio);
+void gpio_put(uint gpio, bool value);
+
+static inline void gpio_init(uint gpio) { (void)gpio; }
+static inline void gpio_set_dir(uint gpio, bool out) { (void)gpio; (void)out; }
+static inline void gpio_pull_up(uint gpio) { (void)gpio; }
+static inline void gpio_pull_down(uint gpio) { (void)gpio; }
+static inline void gpio_disable_pulls(uint gpio) { (void)gpio; }
+static inline void gpio_set_function(uint gpio, uint fn) { (void)gpio; (void)fn; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_HARDWARE_GPIO_H
@@ -0,0 +1,39 @@
+/**
+ * @file hardware/irq.h
+ * @brief Host stand-in for the Pico SDK interrupt API.
+ * @details The host runs every "interrupt" synchronously from the clock, so
+ *          there is nothing to enable or mask.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_HARDWARE_IRQ_H
+#define HOST_HARDWARE_IRQ_H
+
+#include "pico/types.h"
+
+#define DMA_IRQ_0 11
+#define UART0_IRQ 20
+#define PICO_SHARED_IRQ_HANDLER_HIGHEST_ORDER_PRIORITY 0xff
+
+typedef void (*irq_handler_t)(void);
+
+static inline void irq_set_enabled(uint num, bool enabled) {
+    (void)num;
+    (void)enabled;
+}
+
+static inline void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    (void)num;
+    (void)handler;
+}
+
+static inline void irq_add_shared_handler(uint num, irq_handler_t handler,
+                                          uint8_t order_priority) {
+    (void)num;
+    (void)handler;
+    (void)order_priority;
+}
+
+#endif // HOST_HARDWARE_IRQ_H
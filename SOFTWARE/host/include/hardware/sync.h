@@ -0,0 +1,20 @@
+/**
+ * @file hardware/sync.h
+ * @brief Host stand-in for the Pico SDK interrupt masking API.
+ * @details Host "interrupts" only run from the clock, never in the middle of
+ *          a statement, so masking them is a no-op.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico/types.h"
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+#endif // HOST_HARDWARE_SYNC_H
@@ -0,0 +1,59 @@
+/**
+ * @file hardware/uart.h
+ * @brief Host stand-in for the Pico SDK UART API.
+ * @details Transmitted bytes are forwarded to the active `HostHal`. Only the
+ *          transmit side is modelled because the firmware never reads back
+ *          from the sound module. The FIFO never fills, so a transmit ring
+ *          drains completely from the writer and the TX interrupt never runs.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_HARDWARE_UART_H
+#define HOST_HARDWARE_UART_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Opaque UART handle; the host only has the one instance. */
+typedef struct uart_inst uart_inst_t;
+
+extern uart_inst_t *const host_uart0;
+#define uart0 host_uart0
+
+#define UART_FUNCSEL_NUM(uart, gpio) 2
+
+void uart_putc_raw(uart_inst_t *uart, char c);
+
+static inline uint uart_init(uart_inst_t *uart, uint baudrate) {
+    (void)uart;
+    return baudrate;
+}
+
+static inline bool uart_is_writable(uart_inst_t *uart) {
+    (void)uart;
+    return true;
+}
+
+static inline void uart_set_irq_enables(uart_inst_t *uart, bool rx_has_data,
+                                        bool tx_needs_data) {
+    (void)uart;
+    (void)rx_has_data;
+    (void)tx_needs_data;
+}
+
+static inline void uart_puts(uart_inst_t *uart, const char *s) {
+    while (*s) {
+        uart_putc_raw(uart, *s++);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_HARDWARE_UART_H
@@ -0,0 +1,72 @@
+/**
+ * @file host_arduino.h
+ * @brief Host half of the Arduino shim.
+ * @details Included by `Arduino.h` when `KLYSTRON_HOST_BUILD` is defined. The
+ *          timing functions are declared with the same C linkage and
+ *          signatures as FastLED's stub platform so the firmware, RAMP and
+ *          FastLED all share one definition, backed by the host clock.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "pico/time.h"
+
+// Spelled exactly as FastLED's stub platform spells them so the later
+// definitions there are benign redefinitions.
+#ifndef HIGH
+#  define HIGH 1
+#endif
+#ifndef LOW
+#  define LOW 0
+#endif
+#ifndef INPUT
+#  define INPUT  0
+#endif
+#ifndef OUTPUT
+#  define OUTPUT 1
+#endif
+#ifndef INPUT_PULLUP
+#  define INPUT_PULLUP 2
+#endif
+#ifndef INPUT_PULLDOWN
+#  define INPUT_PULLDOWN 0x3
+#endif
+#ifndef M_PI
+#  define M_PI 3.14159265358979323846
+#endif
+
+#ifdef __cplusplus
+using boolean = bool;
+using byte    = uint8_t;
+#else
+typedef bool    boolean;
+typedef uint8_t byte;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void pinMode(uint8_t pin, uint8_t mode);
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(int ms);
+void yield(void);
+#ifdef __cplusplus
+}
+#endif
+
+static inline void digitalWrite(uint pin, int v) { gpio_put(pin, v != 0); }
+static inline int  digitalRead(uint pin) { return gpio_get(pin) ? HIGH : LOW; }
+static inline void delayMicroseconds(unsigned long us) { sleep_us(us); }
+
+// Interrupts are delivered synchronously from the host clock, so masking
+// them is a no-op.
+static inline void noInterrupts() {}
+static inline void interrupts()   {}
@@ -0,0 +1,45 @@
+/**
+ * @file pico/stdlib.h
+ * @brief Host stand-in for the Pico SDK standard library header.
+ * @details Pulls in the host versions of the SDK headers the firmware
+ *          expects `pico/stdlib.h` to provide.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include "pico/types.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Body of a busy-wait loop.
+ * @details On the board this is a no-op. The host has nothing else to move
+ *          time forward inside a spin, so it advances the clock by a small
+ *          fixed step instead, which lets polling loops time out and lets
+ *          repeating timers run while they spin.
+ */
+void tight_loop_contents(void);
+
+bool stdio_init_all(void);
+
+/**
+ * @brief Reports a fatal error and stops.
+ * @details The SDK prints the message and halts the core; the host prints
+ *          it to stderr and aborts, so a test or fuzz run fails on it.
+ */
+void panic(const char *fmt, ...) __attribute__((noreturn, format(printf, 1, 2)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_PICO_STDLIB_H
@@ -0,0 +1,74 @@
+/**
+ * @file pico/time.h
+ * @brief Host stand-in for the Pico SDK time API.
+ * @details Every call reads or advances the host clock (see `host_clock.h`).
+ *          Sleeping advances the clock and runs any repeating timer that
+ *          falls due, so the pack timer ISR interleaves with the main loop
+ *          exactly as often as it would on the board.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_PICO_TIME_H
+#define HOST_PICO_TIME_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct repeating_timer;
+
+/** @brief Repeating timer callback; return false to stop the timer. */
+typedef bool (*repeating_timer_callback_t)(struct repeating_timer *rt);
+
+/** @brief Repeating timer state, laid out like the SDK's for the fields used. */
+struct repeating_timer {
+    int64_t delay_us;
+    int32_t alarm_id;
+    repeating_timer_callback_t callback;
+    void *user_data;
+};
+typedef struct repeating_timer repeating_timer_t;
+
+absolute_time_t get_absolute_time(void);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_us(uint64_t us);
+bool add_repeating_timer_us(int64_t delay_us,
+                            repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out);
+bool cancel_repeating_timer(repeating_timer_t *timer);
+
+static inline bool add_repeating_timer_ms(int32_t delay_ms,
+                                          repeating_timer_callback_t callback,
+                                          void *user_data,
+                                          repeating_timer_t *out) {
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback,
+                                  user_data, out);
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+
+static inline int64_t absolute_time_diff_us(absolute_time_t from,
+                                            absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return get_absolute_time() + (uint64_t)ms * 1000;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_PICO_TIME_H
@@ -0,0 +1,23 @@
+/**
+ * @file pico/types.h
+ * @brief Host stand-in for the Pico SDK base types.
+ * @details Provides just the SDK types the firmware sources use so they can
+ *          be compiled unchanged for the host build.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef HOST_PICO_TYPES_H
+#define HOST_PICO_TYPES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+/** @brief Microseconds since boot on the host clock. */
+typedef uint64_t absolute_time_t;
+
+#endif // HOST_PICO_TYPES_H
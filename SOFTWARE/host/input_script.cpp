@@ -0,0 +1,179 @@
+/**
+ * @file input_script.cpp
+ * @brief Scripted pack inputs for host runs.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "input_script.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "stub_hal.h"
+
+/** @brief A switch and the GPIO it is read from (see `init_gpio`). */
+struct ScriptSwitch {
+    const char *name;
+    unsigned pin;
+};
+
+static const ScriptSwitch script_switches[] = {
+    {"pack_pu", 11}, {"vent", 13}, {"song", 14}, {"fire", 15}, {"pu", 16},
+};
+
+/** @brief The DIP switch GPIOs: bit `b` of `config_dip_sw` is pin 10 - b. */
+static const unsigned SCRIPT_DIP_LOW_PIN = 6;
+static const unsigned SCRIPT_DIP_HIGH_PIN = 10;
+
+static const ScriptSwitch *find_switch(const std::string &name) {
+    for (const ScriptSwitch &sw : script_switches) {
+        if (name == sw.name) {
+            return &sw;
+        }
+    }
+    return nullptr;
+}
+
+/** @brief Parses `1.2s`, `300ms`, `50us` or a bare millisecond count. */
+static bool parse_time_us(const char *text, uint64_t *us) {
+    char *end;
+    double v = strtod(text, &end);
+    if (end == text || v < 0) {
+        return false;
+    }
+    double scale;
+    if (strcmp(end, "s") == 0) {
+        scale = 1e6;
+    } else if (strcmp(end, "ms") == 0 || *end == '\0') {
+        scale = 1e3;
+    } else if (strcmp(end, "us") == 0) {
+        scale = 1;
+    } else {
+        return false;
+    }
+    *us = (uint64_t)(v * scale + 0.5);
+    return true;
+}
+
+static bool parse_value(const char *text, long max, uint16_t *value) {
+    char *end;
+    long v = strtol(text, &end, 0);
+    if (end == text || *end != '\0' || v < 0 || v > max) {
+        return false;
+    }
+    *value = (uint16_t)v;
+    return true;
+}
+
+bool input_script_load(const char *path, std::vector<InputEvent> *events,
+                       std::string *error) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        *error = std::string(path) + ": cannot open";
+        return false;
+    }
+    events->clear();
+    char line[256];
+    int line_no = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        line_no++;
+        char *hash = strchr(line, '#');
+        if (hash) {
+            *hash = '\0';
+        }
+        char *words[5];
+        int count = 0;
+        for (char *w = strtok(line, " \t\r\n"); w; w = strtok(nullptr, " \t\r\n")) {
+            if (count == 5) {
+                count++;
+                break;
+            }
+            words[count++] = w;
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        const char *reason = nullptr;
+        InputEvent ev;
+        uint64_t hold_us = 0;
+        if (count != 3 && !(count == 5 && strcmp(words[3], "for") == 0)) {
+            reason = "expected: time input value [for duration]";
+        } else if (!parse_time_us(words[0], &ev.at_us)) {
+            reason = "bad time";
+        } else if (count == 5 && !parse_time_us(words[4], &hold_us)) {
+            reason = "bad duration";
+        } else {
+            ev.input = words[1];
+            const char *value = words[2];
+            if (find_switch(ev.input)) {
+                if (strcmp(value, "on") == 0) {
+                    ev.value = 1;
+                } else if (strcmp(value, "off") == 0) {
+                    ev.value = 0;
+                } else {
+                    reason = "switches take on or off";
+                }
+            } else if (ev.input == "dip") {
+                if (!parse_value(value, 0x1F, &ev.value)) {
+                    reason = "dip takes 0 to 0x1F";
+                }
+            } else if (ev.input == "adj0" || ev.input == "adj1") {
+                if (!parse_value(value, 0xFFF, &ev.value)) {
+                    reason = "adj takes 0 to 0xFFF";
+                }
+            } else {
+                reason = "unknown input";
+            }
+            if (!reason && count == 5 && !(find_switch(ev.input) && ev.value)) {
+                reason = "for only follows a switch turned on";
+            }
+        }
+        if (reason) {
+            *error = std::string(path) + ":" + std::to_string(line_no) + ": " + reason;
+            ok = false;
+            break;
+        }
+
+        events->push_back(ev);
+        if (count == 5) {
+            InputEvent release = ev;
+            release.at_us += hold_us;
+            release.value = 0;
+            events->push_back(release);
+        }
+    }
+    fclose(f);
+    std::stable_sort(events->begin(), events->end(),
+                     [](const InputEvent &a, const InputEvent &b) {
+                         return a.at_us < b.at_us;
+                     });
+    return ok;
+}
+
+void input_script_schedule(const std::vector<InputEvent> &events, StubHal &hal) {
+    for (const InputEvent &ev : events) {
+        if (const ScriptSwitch *sw = find_switch(ev.input)) {
+            hal.scheduleInput(ev.at_us, sw->pin, ev.value == 0);
+        } else if (ev.input == "dip") {
+            for (unsigned pin = SCRIPT_DIP_LOW_PIN; pin <= SCRIPT_DIP_HIGH_PIN; pin++) {
+                bool on = ev.value & (1u << (SCRIPT_DIP_HIGH_PIN - pin));
+                hal.scheduleInput(ev.at_us, pin, !on);
+            }
+        } else {
+            hal.scheduleAdc(ev.at_us, ev.input == "adj0" ? 0 : 1, ev.value);
+        }
+    }
+}
+
+void input_script_set_dip(StubHal &hal, uint8_t dip) {
+    for (unsigned pin = SCRIPT_DIP_LOW_PIN; pin <= SCRIPT_DIP_HIGH_PIN; pin++) {
+        hal.setInput(pin, !(dip & (1u << (SCRIPT_DIP_HIGH_PIN - pin))));
+    }
+}
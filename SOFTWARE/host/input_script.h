@@ -0,0 +1,69 @@
+/**
+ * @file input_script.h
+ * @brief Scripted pack inputs for host runs.
+ * @details A script is a text file with one input change per line:
+ *
+ *          ```
+ *          # time  input    value   [for duration]
+ *          0       pack_pu  on
+ *          1.2s    pu       on
+ *          3s      fire     on      for 2.5s
+ *          6s      vent     on      for 300ms
+ *          9s      adj1     0xE00
+ *          ```
+ *
+ *          Times and durations are milliseconds unless suffixed `s`, `ms`
+ *          or `us`. Switches (`pack_pu`, `pu`, `fire`, `vent`, `song`) take
+ *          `on` or `off`; `for` turns the switch back off after the given
+ *          time. `dip` takes the 5-bit CONFIG switch value as read into
+ *          `config_dip_sw` (0x01 Pack Sel0 ... 0x10 Hum). `adj0` and `adj1`
+ *          take the 12-bit potentiometer reading that lands in `adj_pot[]`.
+ *          Everything after `#` is a comment.
+ *
+ *          Inputs are scheduled on the `StubHal` as pin and ADC levels, so
+ *          the firmware sees each change through its own debounce and
+ *          smoothing at exactly the scripted time.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class StubHal;
+
+/** @brief One scripted input change. */
+struct InputEvent {
+    uint64_t at_us;    /**< When the input changes, on the host clock. */
+    std::string input; /**< Input name as written in the script. */
+    uint16_t value;    /**< 1/0 for switches, the raw value otherwise. */
+};
+
+/**
+ * @brief Reads a script, expanding `for` into a second, releasing event.
+ * @param path The script file.
+ * @param events Receives the events sorted by time.
+ * @param error Receives `file:line: reason` when the script is rejected.
+ * @return false if the file could not be read or a line is malformed.
+ */
+bool input_script_load(const char *path, std::vector<InputEvent> *events,
+                       std::string *error);
+
+/**
+ * @brief Schedules every event on `hal`.
+ * @details Switches and DIP switches are active low, as on the board.
+ */
+void input_script_schedule(const std::vector<InputEvent> &events, StubHal &hal);
+
+/**
+ * @brief Sets the CONFIG switches to `dip` straight away.
+ * @details For choosing the pack type before `klystron_init()` reads it.
+ */
+void input_script_set_dip(StubHal &hal, uint8_t dip);
+
+#endif // INPUT_SCRIPT_H
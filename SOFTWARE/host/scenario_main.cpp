@@ -0,0 +1,427 @@
+/**
+ * @file scenario_main.cpp
+ * @brief Runs the firmware against a scripted input timeline.
+ * @details Loads an input script (see `input_script.h`), schedules it on the
+ *          stub hardware and runs the normal start-up sequence and state
+ *          machine loop, exactly as `klystron_host` does, until the script
+ *          has finished and `--tail` more milliseconds have passed.
+ *
+ *          Usage: `klystron_scenario <script> [--pack TYPE] [--frames FILE]
+ *          [--tail MS]`
+ *
+ *          `--pack` sets the Pack Sel and Heat CONFIG switches before the
+ *          firmware starts: `snap_red`, `fade_red`, `tvg`, `afterlife`,
+ *          `afterlife_tvg`, or `all` to run the script once per pack type.
+ *          A `dip` line in the script overrides it from that time on.
+ *          `--frames` records the LEDs once per pack timer tick, all strips
+ *          side by side, as a frame stream that `sim_frames` can export
+ *          (with `all`, the pack type is appended to the name). The firmware
+ *          only shows a frame when a strip changed, so a tick without one
+ *          repeats the last frame.
+ *
+ *          The log on stdout interleaves every input change, pack state
+ *          transition and sound module command with its time. It ends with
+ *          the latency from each input change to the first changed pixel,
+ *          the first sound command on the UART and the first state
+ *          transition it caused. "Caused" is measured, not guessed: for each
+ *          input time the script is run again without the changes at that
+ *          time, and a latency is where the two runs first differ. A `-`
+ *          means the change made no difference of that kind before the run
+ *          ended. Every run starts from a fresh process, because the
+ *          firmware keeps its state in statics.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "fl/hash.h"
+#include "frame_recorder.h"
+#include "host_clock.h"
+#include "input_script.h"
+#include "stub_hal.h"
+#include "klystron.h"
+#include "klystron_IO_support.h"
+#include "pack_config.h"
+#include "pack_state.h"
+
+/** @brief Simulated cost of a state machine pass that neither sleeps nor spins. */
+static const uint64_t HOST_IDLE_PASS_US = 100;
+
+/** @brief A `--pack` name and the CONFIG switches that select it. */
+struct ScenarioPack {
+    const char *name;
+    uint8_t dip;
+};
+
+static const ScenarioPack scenario_packs[] = {
+    {"snap_red", 0},
+    {"fade_red", DIP_PACKSEL0_MASK},
+    {"tvg", DIP_PACKSEL1_MASK},
+    {"afterlife", DIP_PACKSEL_MASK},
+    {"afterlife_tvg", DIP_PACKSEL_MASK | DIP_HEAT_MASK},
+};
+
+static const char *const state_names[] = {
+    "PS_OFF",           "PS_PACK_STANDBY", "PS_WAND_STANDBY", "PS_IDLE",
+    "PS_FIRE",          "PS_FIRE_COOLDOWN", "PS_SLIME_FIRE",  "PS_OVERHEAT",
+    "PS_OVERHEAT_BEEP", "PS_AUTOVENT",     "PS_FEEDBACK",
+};
+
+/** @brief Something the firmware did at a point in time. */
+struct TraceEntry {
+    uint64_t at_us;
+    uint32_t what; // cmd << 8 | param for sounds, the state for transitions
+};
+
+/** @brief Everything a run did, for comparing one run with another. */
+struct RunTrace {
+    std::vector<uint32_t> frames; // hash of the LEDs at every tick
+    std::vector<TraceEntry> sounds;
+    std::vector<TraceEntry> states;
+};
+
+/** @brief How one run is set up. */
+struct RunConfig {
+    const ScenarioPack *pack;
+    std::vector<InputEvent> events;
+    uint64_t end_us;
+    std::string frames_path; // empty for no stream
+    bool log;
+};
+
+static void usage() {
+    fprintf(stderr, "usage: klystron_scenario <script> [--pack TYPE|all] "
+                    "[--frames FILE] [--tail MS]\n");
+}
+
+static void describe(const InputEvent &ev, char *buf, size_t len) {
+    if (ev.input == "dip" || ev.input == "adj0" || ev.input == "adj1") {
+        snprintf(buf, len, "%s 0x%03x", ev.input.c_str(), ev.value);
+    } else {
+        snprintf(buf, len, "%s %s", ev.input.c_str(), ev.value ? "on" : "off");
+    }
+}
+
+/** @brief Runs the firmware once. Only ever called in a fresh process. */
+static bool run_scenario(const RunConfig &cfg, RunTrace *trace) {
+    StubHal &hal = host_stub_hal();
+    hal.setTrace(cfg.log ? stdout : nullptr);
+    if (cfg.pack) {
+        input_script_set_dip(hal, cfg.pack->dip);
+    }
+    input_script_schedule(cfg.events, hal);
+
+    const uint64_t tick_us = (uint64_t)pack_isr_interval_ms * 1000;
+    FrameStreamWriter stream;
+    bool stream_failed = false;
+    std::vector<uint8_t> row;
+    uint32_t row_hash = 0;
+    size_t logged = 0;
+
+    // Inputs are logged from every hook, so they land in time order among
+    // the sound and state lines even while start-up has the main loop held.
+    auto log_inputs = [&](uint64_t now) {
+        while (logged < cfg.events.size() && cfg.events[logged].at_us <= now) {
+            const InputEvent &ev = cfg.events[logged++];
+            char what[32];
+            describe(ev, what, sizeof(what));
+            if (cfg.log) {
+                printf("%10.3f ms  input %s\n", ev.at_us / 1000.0, what);
+            }
+        }
+    };
+
+    // Fills every tick before `now` with the last frame shown; ticks before
+    // the first frame are dark (hash 0).
+    auto catch_up = [&](uint64_t now) {
+        while (trace->frames.size() < now / tick_us) {
+            trace->frames.push_back(row.empty() ? 0 : row_hash);
+            if (stream.is_open()) {
+                stream.write(row.data());
+            }
+        }
+    };
+
+    hal.setShowCallback([&](const HostLedStrip *strips, size_t count, uint8_t brightness) {
+        const uint64_t now = host_clock_now_us();
+        log_inputs(now);
+        catch_up(now);
+        row.clear();
+        for (size_t s = 0; s < count; s++) {
+            for (size_t i = 0; i < strips[s].num_leds; i++) {
+                const CRGB &c = strips[s].leds[i];
+                row.push_back((uint8_t)((c.r * brightness) / 255));
+                row.push_back((uint8_t)((c.g * brightness) / 255));
+                row.push_back((uint8_t)((c.b * brightness) / 255));
+            }
+        }
+        row_hash = fl::MurmurHash3_x86_32(row.data(), row.size());
+        if (!cfg.frames_path.empty() && !stream.is_open() && !stream_failed) {
+            stream_failed = !stream.open(cfg.frames_path, (int)(row.size() / 3),
+                                         Layout::Strip, (int)(1000 / pack_isr_interval_ms));
+            // Ticks before the first frame were dark.
+            std::vector<uint8_t> dark(row.size(), 0);
+            for (size_t i = 0; stream.is_open() && i < trace->frames.size(); i++) {
+                stream.write(dark.data());
+            }
+        }
+    });
+
+    hal.setSoundCallback([&](uint8_t cmd, uint8_t param) {
+        const uint64_t now = host_clock_now_us();
+        log_inputs(now);
+        trace->sounds.push_back({now, (uint32_t)(cmd << 8 | param)});
+    });
+
+    if (cfg.log && cfg.pack) {
+        printf("pack %s\n", cfg.pack->name);
+    }
+    klystron_init();
+
+    PackState last_state = pack_state_get_state();
+    if (cfg.log) {
+        printf("%10.3f ms  state %s\n", host_clock_now_us() / 1000.0,
+               state_names[last_state]);
+    }
+    while (host_clock_now_us() < cfg.end_us) {
+        const uint64_t before = host_clock_now_us();
+        pack_state_process();
+        const uint64_t now = host_clock_now_us();
+        log_inputs(now);
+        PackState state = pack_state_get_state();
+        if (state != last_state) {
+            if (cfg.log) {
+                printf("%10.3f ms  state %s -> %s\n", now / 1000.0,
+                       state_names[last_state], state_names[state]);
+            }
+            last_state = state;
+            trace->states.push_back({now, (uint32_t)state});
+        }
+        if (now == before) {
+            host_clock_advance_us(HOST_IDLE_PASS_US);
+        }
+    }
+    log_inputs(cfg.end_us);
+    catch_up(cfg.end_us);
+    stream.close();
+    fflush(stdout);
+    return !stream_failed;
+}
+
+static bool write_all(int fd, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (len) {
+        ssize_t n = write(fd, p, len);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool read_all(int fd, void *data, size_t len) {
+    uint8_t *p = (uint8_t *)data;
+    while (len) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+template <typename T> static bool write_vector(int fd, const std::vector<T> &v) {
+    uint64_t n = v.size();
+    return write_all(fd, &n, sizeof(n)) && write_all(fd, v.data(), n * sizeof(T));
+}
+
+template <typename T> static bool read_vector(int fd, std::vector<T> *v) {
+    uint64_t n;
+    if (!read_all(fd, &n, sizeof(n))) {
+        return false;
+    }
+    v->resize(n);
+    return read_all(fd, v->data(), n * sizeof(T));
+}
+
+/** @brief Runs `cfg` in a child process and collects its trace. */
+static bool run_in_child(const RunConfig &cfg, RunTrace *trace) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    fflush(stdout);
+    pid_t child = fork();
+    if (child < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (child == 0) {
+        close(fds[0]);
+        RunTrace t;
+        bool ok = run_scenario(cfg, &t);
+        ok = write_vector(fds[1], t.frames) && write_vector(fds[1], t.sounds) &&
+             write_vector(fds[1], t.states) && ok;
+        _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    bool ok = read_vector(fds[0], &trace->frames) && read_vector(fds[0], &trace->sounds) &&
+              read_vector(fds[0], &trace->states);
+    close(fds[0]);
+    int status = 1;
+    return waitpid(child, &status, 0) == child && WIFEXITED(status) &&
+           WEXITSTATUS(status) == 0 && ok;
+}
+
+/** @brief Time of the first entry where two runs differ, or -1. */
+static int64_t first_difference(const std::vector<TraceEntry> &a,
+                                const std::vector<TraceEntry> &b) {
+    size_t n = std::min(a.size(), b.size());
+    for (size_t i = 0; i < n; i++) {
+        if (a[i].at_us != b[i].at_us || a[i].what != b[i].what) {
+            return (int64_t)std::min(a[i].at_us, b[i].at_us);
+        }
+    }
+    if (a.size() != b.size()) {
+        return (int64_t)(a.size() > n ? a[n].at_us : b[n].at_us);
+    }
+    return -1;
+}
+
+static void print_latency(int64_t at_us, uint64_t edge_us) {
+    if (at_us < 0) {
+        printf("  %10s", "-");
+    } else {
+        printf("  %10.3f", (at_us - (int64_t)edge_us) / 1000.0);
+    }
+}
+
+/** @brief The full run with its log, then one run per input time without it. */
+static bool run_pack(const std::vector<InputEvent> &events, const ScenarioPack *pack,
+                     const std::string &frames_path, uint64_t end_us) {
+    RunConfig cfg = {pack, events, end_us, frames_path, true};
+    RunTrace full;
+    if (!run_in_child(cfg, &full)) {
+        fprintf(stderr, "scenario run failed\n");
+        return false;
+    }
+
+    const uint64_t tick_us = (uint64_t)pack_isr_interval_ms * 1000;
+    printf("\nlatency (ms)                        pixel       sound       state\n");
+    for (size_t begin = 0; begin < events.size();) {
+        const uint64_t edge_us = events[begin].at_us;
+        size_t end = begin;
+        std::string what;
+        while (end < events.size() && events[end].at_us == edge_us) {
+            char buf[32];
+            describe(events[end++], buf, sizeof(buf));
+            what += what.empty() ? buf : std::string(", ") + buf;
+        }
+
+        RunConfig base_cfg = {pack, events, end_us, "", false};
+        base_cfg.events.erase(base_cfg.events.begin() + begin, base_cfg.events.begin() + end);
+        RunTrace base;
+        if (!run_in_child(base_cfg, &base)) {
+            fprintf(stderr, "baseline run failed\n");
+            return false;
+        }
+
+        int64_t pixel = -1;
+        size_t ticks = std::min(full.frames.size(), base.frames.size());
+        for (size_t k = 0; k < ticks; k++) {
+            if (full.frames[k] != base.frames[k]) {
+                pixel = (int64_t)(k * tick_us);
+                break;
+            }
+        }
+        printf("%10.3f ms  %-18s", edge_us / 1000.0, what.c_str());
+        print_latency(pixel, edge_us);
+        print_latency(first_difference(full.sounds, base.sounds), edge_us);
+        print_latency(first_difference(full.states, base.states), edge_us);
+        printf("\n");
+        begin = end;
+    }
+    fflush(stdout);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *script = nullptr;
+    const char *pack_name = nullptr;
+    std::string frames_path;
+    uint32_t tail_ms = 3000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc) {
+            pack_name = argv[++i];
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames_path = argv[++i];
+        } else if (strcmp(argv[i], "--tail") == 0 && i + 1 < argc) {
+            tail_ms = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (argv[i][0] != '-' && !script) {
+            script = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!script) {
+        usage();
+        return 2;
+    }
+
+    std::vector<InputEvent> events;
+    std::string error;
+    if (!input_script_load(script, &events, &error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    const uint64_t end_us =
+        (events.empty() ? 0 : events.back().at_us) + (uint64_t)tail_ms * 1000;
+
+    std::vector<const ScenarioPack *> packs;
+    if (!pack_name) {
+        packs.push_back(nullptr);
+    } else {
+        for (const ScenarioPack &p : scenario_packs) {
+            if (strcmp(pack_name, "all") == 0 || strcmp(pack_name, p.name) == 0) {
+                packs.push_back(&p);
+            }
+        }
+        if (packs.empty()) {
+            fprintf(stderr, "unknown pack type %s\n", pack_name);
+            return 2;
+        }
+    }
+
+    bool ok = true;
+    for (const ScenarioPack *p : packs) {
+        std::string path = frames_path;
+        if (!path.empty() && packs.size() > 1) {
+            size_t dot = path.rfind('.');
+            size_t slash = path.rfind('/');
+            if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+                dot = path.size();
+            }
+            path.insert(dot, std::string("_") + p->name);
+        }
+        if (p != packs.front()) {
+            printf("\n");
+        }
+        ok = run_pack(events, p, path, end_us) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file stub_hal.cpp
+ * @brief Default hardware model for the host build.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "stub_hal.h"
+#include <algorithm>
+#include "host_clock.h"
+#include "pack_config.h"
+
+/** @brief Sound module commands the firmware sends. */
+enum {
+    SOUND_CMD_LOOP = 0x08,
+    SOUND_CMD_RESUME = 0x0D,
+    SOUND_CMD_PAUSE = 0x0E,
+    SOUND_CMD_PLAY = 0x0F,
+    SOUND_CMD_VOLUME = 0x06,
+    SOUND_CMD_STOP = 0x16,
+};
+
+StubHal::StubHal() : trace_(nullptr) { reset(); }
+
+void StubHal::reset() {
+    scheduled_.clear();
+    inputs_ = 0xFFFFFFFFu;
+    outputs_ = 0;
+    for (uint16_t &v : adc_) {
+        v = 0;
+    }
+    rx_len_ = 0;
+    for (uint32_t &ms : track_ms_) {
+        ms = 0;
+    }
+    default_track_ms_ = 2000;
+    busy_latency_us_ = 20000;
+    track_ = 0;
+    volume_ = 0;
+    playing_ = false;
+    looping_ = false;
+    busy_from_us_ = 0;
+    busy_until_us_ = 0;
+    paused_left_us_ = 0;
+    frames_shown_ = 0;
+    show_cb_ = nullptr;
+    sound_cb_ = nullptr;
+}
+
+void StubHal::setInput(unsigned pin, bool level) {
+    if (pin < 32) {
+        inputs_ = level ? (inputs_ | (1u << pin)) : (inputs_ & ~(1u << pin));
+    }
+}
+
+bool StubHal::output(unsigned pin) const {
+    return pin < 32 && (outputs_ & (1u << pin)) != 0;
+}
+
+void StubHal::setAdc(unsigned input, uint16_t value) {
+    if (input < 4) {
+        adc_[input] = value & 0x0FFF;
+    }
+}
+
+void StubHal::scheduleInput(uint64_t at_us, unsigned pin, bool level) {
+    schedule({at_us, false, pin, level});
+}
+
+void StubHal::scheduleAdc(uint64_t at_us, unsigned input, uint16_t value) {
+    schedule({at_us, true, input, value});
+}
+
+void StubHal::schedule(const ScheduledInput &in) {
+    // Kept sorted by time; upper_bound keeps same-time changes in order.
+    scheduled_.insert(std::upper_bound(scheduled_.begin(), scheduled_.end(), in,
+                                       [](const ScheduledInput &x,
+                                          const ScheduledInput &y) {
+                                           return x.at_us < y.at_us;
+                                       }),
+                      in);
+}
+
+void StubHal::applyScheduled() {
+    const uint64_t now = host_clock_now_us();
+    size_t due = 0;
+    while (due < scheduled_.size() && scheduled_[due].at_us <= now) {
+        const ScheduledInput &in = scheduled_[due++];
+        if (in.adc) {
+            setAdc(in.index, in.value);
+        } else {
+            setInput(in.index, in.value != 0);
+        }
+    }
+    scheduled_.erase(scheduled_.begin(), scheduled_.begin() + due);
+}
+
+void StubHal::setTrackDurationMs(uint8_t track, uint32_t ms) {
+    track_ms_[track] = ms;
+}
+
+void StubHal::setDefaultTrackDurationMs(uint32_t ms) { default_track_ms_ = ms; }
+
+void StubHal::setBusyLatencyUs(uint32_t us) { busy_latency_us_ = us; }
+
+void StubHal::setShowCallback(ShowCallback cb) { show_cb_ = cb; }
+
+void StubHal::setSoundCallback(SoundCallback cb) { sound_cb_ = cb; }
+
+void StubHal::setTrace(FILE *trace) { trace_ = trace; }
+
+bool StubHal::soundPlaying() const {
+    const uint64_t now = host_clock_now_us();
+    return playing_ && now >= busy_from_us_ &&
+           (looping_ || now < busy_until_us_);
+}
+
+bool StubHal::gpioGet(unsigned pin) {
+    applyScheduled();
+    if (pin == pack_sound_busy_pin) {
+        return soundPlaying() ? pack_sound_busy_level
+                              : (pack_sound_busy_level ^ 1);
+    }
+    return pin < 32 && (inputs_ & (1u << pin)) != 0;
+}
+
+void StubHal::gpioPut(unsigned pin, bool value) {
+    if (pin < 32) {
+        outputs_ = value ? (outputs_ | (1u << pin)) : (outputs_ & ~(1u << pin));
+    }
+}
+
+uint16_t StubHal::adcRead(unsigned input) {
+    applyScheduled();
+    return input < 4 ? adc_[input] : 0;
+}
+
+void StubHal::uartPutc(uint8_t c) {
+    // Resynchronise on the start byte so a dropped byte only costs one frame.
+    if (c == 0x7E) {
+        rx_len_ = 0;
+    }
+    if (rx_len_ < kSoundFrameLen) {
+        rx_[rx_len_++] = c;
+    }
+    if (rx_len_ == kSoundFrameLen) {
+        if (rx_[0] == 0x7E && rx_[kSoundFrameLen - 1] == 0xEF) {
+            handleSoundFrame(rx_);
+        }
+        rx_len_ = 0;
+    }
+}
+
+void StubHal::showLeds(const HostLedStrip *strips, size_t count,
+                       uint8_t brightness) {
+    frames_shown_++;
+    if (show_cb_) {
+        show_cb_(strips, count, brightness);
+    }
+}
+
+void StubHal::startTrack(uint8_t track, bool loop) {
+    const uint64_t now = host_clock_now_us();
+    const uint32_t ms = track_ms_[track] ? track_ms_[track] : default_track_ms_;
+    track_ = track;
+    playing_ = true;
+    looping_ = loop;
+    busy_from_us_ = now + busy_latency_us_;
+    busy_until_us_ = busy_from_us_ + (uint64_t)ms * 1000;
+}
+
+void StubHal::handleSoundFrame(const uint8_t *frame) {
+    const uint8_t cmd = frame[3];
+    const uint8_t param = frame[6];
+    const uint64_t now = host_clock_now_us();
+    const char *what = nullptr;
+
+    switch (cmd) {
+    case SOUND_CMD_PLAY:
+        startTrack(param, false);
+        what = "play";
+        break;
+    case SOUND_CMD_LOOP:
+        startTrack(param, true);
+        what = "loop";
+        break;
+    case SOUND_CMD_STOP:
+        playing_ = false;
+        what = "stop";
+        break;
+    case SOUND_CMD_PAUSE:
+        if (soundPlaying()) {
+            paused_left_us_ = busy_until_us_ - now;
+            playing_ = false;
+        }
+        what = "pause";
+        break;
+    case SOUND_CMD_RESUME:
+        if (!playing_ && paused_left_us_) {
+            playing_ = true;
+            busy_from_us_ = now;
+            busy_until_us_ = now + paused_left_us_;
+            paused_left_us_ = 0;
+        }
+        what = "resume";
+        break;
+    case SOUND_CMD_VOLUME:
+        volume_ = param;
+        what = "volume";
+        break;
+    default:
+        what = "unknown";
+        break;
+    }
+
+    if (sound_cb_) {
+        sound_cb_(cmd, param);
+    }
+    if (trace_) {
+        fprintf(trace_, "%10.3f ms  sound %-7s %u\n", now / 1000.0, what,
+                param);
+    }
+}
+
+StubHal &host_stub_hal() {
+    static StubHal hal;
+    return hal;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file stub_hal.h
+ * @brief Default hardware model for the host build.
+ * @details Holds input pins and potentiometers wherever a harness last set
+ *          them, or changes them at scheduled times on the host clock,
+ *          records output pins, counts LED frames and models the
+ *          serial sound module closely enough for the firmware's BUSY-pin
+ *          handshakes to behave: a play command raises BUSY after a short
+ *          latency and drops it once the track's duration has elapsed.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef STUB_HAL_H
+#define STUB_HAL_H
+
+#include <stdio.h>
+#include <functional>
+#include <vector>
+#include "host_hal.h"
+
+/**
+ * @brief The `HostHal` used when a harness does not install its own.
+ */
+class StubHal : public HostHal {
+public:
+    /** @brief Receives every frame passed to `showLeds`. */
+    typedef std::function<void(const HostLedStrip *, size_t, uint8_t)>
+        ShowCallback;
+    /** @brief Receives the command and parameter of every sound frame. */
+    typedef std::function<void(uint8_t cmd, uint8_t param)> SoundCallback;
+
+    StubHal();
+
+    /** @brief Returns every pin, pot and sound setting to its power-on state. */
+    void reset();
+
+    /** @brief Sets the level an input pin reads back. Pins idle high. */
+    void setInput(unsigned pin, bool level);
+    /** @brief Returns the level last driven on an output pin. */
+    bool output(unsigned pin) const;
+    /** @brief Sets the 12-bit value an ADC input converts to. */
+    void setAdc(unsigned input, uint16_t value);
+    /**
+     * @brief Sets an input pin's level once the host clock reaches `at_us`.
+     * @details The change lands at exactly that time however often the
+     *          firmware polls, so a scripted edge is not shifted by the
+     *          harness loop. Changes due at the same time apply in the order
+     *          they were scheduled.
+     */
+    void scheduleInput(uint64_t at_us, unsigned pin, bool level);
+    /** @brief Sets an ADC input's value once the host clock reaches `at_us`. */
+    void scheduleAdc(uint64_t at_us, unsigned input, uint16_t value);
+
+    /** @brief Sets how long a given track plays for. */
+    void setTrackDurationMs(uint8_t track, uint32_t ms);
+    /** @brief Sets how long any track without its own duration plays for. */
+    void setDefaultTrackDurationMs(uint32_t ms);
+    /** @brief Sets the delay between a play command and BUSY asserting. */
+    void setBusyLatencyUs(uint32_t us);
+
+    /** @brief Installs a callback that sees every LED frame. */
+    void setShowCallback(ShowCallback cb);
+    /** @brief Installs a callback that sees every sound module command. */
+    void setSoundCallback(SoundCallback cb);
+    /** @brief Logs sound commands to `trace`, or stops logging if null. */
+    void setTrace(FILE *trace);
+
+    /** @brief Reports whether the modelled sound module is playing. */
+    bool soundPlaying() const;
+    /** @brief Returns the last track index started, 0 if none. */
+    uint8_t currentTrack() const { return track_; }
+    /** @brief Returns the last volume level sent. */
+    uint8_t volume() const { return volume_; }
+    /** @brief Returns the number of frames shown since the last reset. */
+    uint32_t framesShown() const { return frames_shown_; }
+
+    bool gpioGet(unsigned pin) override;
+    void gpioPut(unsigned pin, bool value) override;
+    uint16_t adcRead(unsigned input) override;
+    void uartPutc(uint8_t c) override;
+    void showLeds(const HostLedStrip *strips, size_t count,
+                  uint8_t brightness) override;
+
+private:
+    /** @brief Serial frame length: 7E FF 06 cmd 00 param_hi param_lo EF. */
+    static const size_t kSoundFrameLen = 8;
+
+    /** @brief An input change waiting for its time. */
+    struct ScheduledInput {
+        uint64_t at_us;
+        bool adc;
+        unsigned index;
+        uint16_t value;
+    };
+
+    void handleSoundFrame(const uint8_t *frame);
+    void startTrack(uint8_t track, bool loop);
+    void schedule(const ScheduledInput &in);
+    void applyScheduled();
+
+    std::vector<ScheduledInput> scheduled_;
+    uint32_t inputs_;
+    uint32_t outputs_;
+    uint16_t adc_[4];
+
+    uint8_t rx_[kSoundFrameLen];
+    size_t rx_len_;
+    uint32_t track_ms_[256];
+    uint32_t default_track_ms_;
+    uint32_t busy_latency_us_;
+    uint8_t track_;
+    uint8_t volume_;
+    bool playing_;
+    bool looping_;
+    uint64_t busy_from_us_;
+    uint64_t busy_until_us_;
+    uint64_t paused_left_us_;
+
+    uint32_t frames_shown_;
+    ShowCallback show_cb_;
+    SoundCallback sound_cb_;
+    FILE *trace_;
+};
+
+/**
+ * @brief Returns the shared default stub.
+ */
+StubHal &host_stub_hal();
+
+#endif // STUB_HAL_H
@@ -0,0 +1,213 @@
+/**
+ * @file animation_cases.h
+ * @brief The animation cases shared by the golden-frame test and benchmark.
+ * @details One entry per `Animation` subclass (more for those with a
+ *          direction, bounce or motion blur option). A case runs on the
+ *          cyclotron buffer with `g_cyclotron_led_count` set to the size
+ *          under test and is ticked like the pack timer: `update(4)` with
+ *          the host clock advanced by 4 ms. Cases with a tick schedule are
+ *          ticked by its periods in turn instead, as when frames run late,
+ *          so the catch-up of several steps in one `update()` is exercised.
+ *          At fixed ticks every case starts a colour ramp and then a speed
+ *          ramp, so ramp evaluation is exercised as well.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef ANIMATION_CASES_H
+#define ANIMATION_CASES_H
+
+#include <stdlib.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "host_clock.h"
+#include "animations.h"
+#include "addressable_LED_support.h"
+#include "cyclotron_sequences.h"
+
+/** @brief Pack timer ticks in one run of a case. */
+static const int CASE_TICKS = 500;
+
+/** @brief Tick period, as passed to `update()` (ms). */
+static const uint32_t CASE_TICK_MS = 4;
+
+/** @brief Tick at which every case starts a colour ramp. */
+static const int CASE_COLOR_RAMP_TICK = 150;
+
+/** @brief Tick at which every case starts a speed ramp. */
+static const int CASE_SPEED_RAMP_TICK = 300;
+
+/** @brief The cyclotron ring sizes every case runs at. */
+static const int CASE_SIZES[] = {4, 24, 32, 40};
+
+/** @brief One animation under test. */
+struct AnimationCase {
+    const char *name;
+    std::function<Animation *(PartyModeState *)> make;
+    AnimationConfig config;
+    /** Called before every tick; drives party state the way party mode does. */
+    std::function<void(PartyModeState *, int tick)> drive;
+    /** Tick periods (ms), repeated; empty for `CASE_TICK_MS` every tick. */
+    std::vector<uint32_t> tick_ms = {};
+};
+
+/** @brief Every frame 40 ms late: ten pack timer periods at once. */
+static const std::vector<uint32_t> CASE_LONG_TICKS = {40};
+
+/** @brief Mostly on time, with 64 ms and 40 ms stalls and an odd period. */
+static const std::vector<uint32_t> CASE_IRREGULAR_TICKS = {4, 64, 4, 40, 12, 4, 64, 8};
+
+static inline AnimationConfig make_config(CRGB color, uint16_t speed,
+                                          uint16_t fade_amount = 0, uint16_t steps = 0,
+                                          bool clockwise = true, bool bounce = false,
+                                          bool motion_blur = false) {
+    AnimationConfig c;
+    c.color = color;
+    c.speed = speed;
+    c.fade_amount = fade_amount;
+    c.steps = steps;
+    c.clockwise = clockwise;
+    c.bounce = bounce;
+    c.motion_blur = motion_blur;
+    return c;
+}
+
+static inline void drive_rainbow(PartyModeState *s, int tick) {
+    (void)tick;
+    s->rainbow_hue++;
+}
+
+static inline void drive_sparkle(PartyModeState *s, int tick) {
+    if (tick % 16 == 0) {
+        s->sparkle_strip_index = (tick / 16) % 3;
+        s->sparkle_color = CHSV((uint8_t)(tick * 7), 255, 255);
+    }
+}
+
+static inline void drive_beat_meter(PartyModeState *s, int tick) {
+    s->beat_meter_max_level = 8;
+    if (tick % 5 == 0) {
+        s->beat_meter_level += s->beat_meter_direction;
+        if (s->beat_meter_level >= s->beat_meter_max_level - 1) {
+            s->beat_meter_direction = -1;
+        } else if (s->beat_meter_level <= 0) {
+            s->beat_meter_direction = 1;
+        }
+    }
+}
+
+template <typename T, typename... Args>
+static std::function<Animation *(PartyModeState *)> plain(Args... args) {
+    return [=](PartyModeState *) -> Animation * { return new T(args...); };
+}
+
+static inline std::vector<AnimationCase> animation_cases() {
+    // Off-full channel values, so rounding differences between scaling
+    // routines show up in the hashes.
+    const CRGB red = CRGB(230, 40, 12);
+    const CRGB green = CRGB(9, 200, 40);
+    return {
+        {"ShiftRotate", plain<ShiftRotateAnimation>(), make_config(red, 400), nullptr},
+        {"ShiftRotateCcw", plain<ShiftRotateAnimation>(), make_config(red, 400, 0, 0, false), nullptr},
+        {"RotateFade", plain<RotateFadeAnimation>(), make_config(red, 800, 32, 8), nullptr},
+        {"RotateFadeCcw", plain<RotateFadeAnimation>(), make_config(red, 800, 32, 8, false), nullptr},
+        {"Slime", plain<SlimeAnimation>(), make_config(green, 800, 32, 8), nullptr},
+        {"CylonFadeOut", plain<CylonFadeOutAnimation>(), make_config(red, 1000, 150), nullptr},
+        {"Scroll", plain<ScrollAnimation>(), make_config(red, 600), nullptr},
+        {"Fill", plain<FillAnimation>(), make_config(red, 600), nullptr},
+        {"Drain", plain<DrainAnimation>(), make_config(red, 600), nullptr},
+        {"Strobe", plain<StrobeAnimation>(), make_config(red, 100), nullptr},
+        {"Waterfall", plain<WaterfallAnimation>(), make_config(red, 1500), nullptr},
+        {"Cylon", plain<CylonAnimation>(), make_config(red, 40), nullptr},
+        {"CylonBounce", plain<CylonAnimation>(), make_config(red, 40, 0, 0, true, true), nullptr},
+        {"CylonBlur", plain<CylonAnimation>(), make_config(red, 3, 0, 0, true, false, true), nullptr},
+        {"CylonBlurBounce", plain<CylonAnimation>(), make_config(red, 40, 0, 0, true, true, true), nullptr},
+        {"Rotate", plain<RotateAnimation>(), make_config(red, 400), nullptr},
+        {"RotateCcw", plain<RotateAnimation>(), make_config(red, 400, 0, 0, false), nullptr},
+        {"RotateBlur", plain<RotateAnimation>(), make_config(red, 400, 0, 0, true, false, true), nullptr},
+        {"FadeIn", plain<FadeAnimation>(false), make_config(red, 1000), nullptr},
+        {"FadeOut", plain<FadeAnimation>(true), make_config(red, 1000), nullptr},
+        {"Solid", plain<SolidAnimation>(), make_config(red, 1000), nullptr},
+        {"FadeInLong", plain<FadeAnimation>(false), make_config(red, 1000), nullptr, CASE_LONG_TICKS},
+        {"FadeInIrregular", plain<FadeAnimation>(false), make_config(red, 1000), nullptr, CASE_IRREGULAR_TICKS},
+        {"FadeOutLong", plain<FadeAnimation>(true), make_config(red, 1000), nullptr, CASE_LONG_TICKS},
+        {"FadeOutIrregular", plain<FadeAnimation>(true), make_config(red, 1000), nullptr, CASE_IRREGULAR_TICKS},
+        {"StrobeLong", plain<StrobeAnimation>(), make_config(red, 40), nullptr, CASE_LONG_TICKS},
+        {"StrobeIrregular", plain<StrobeAnimation>(), make_config(red, 40), nullptr, CASE_IRREGULAR_TICKS},
+        {"FillLong", plain<FillAnimation>(), make_config(red, 600), nullptr, CASE_LONG_TICKS},
+        {"FillIrregular", plain<FillAnimation>(), make_config(red, 600), nullptr, CASE_IRREGULAR_TICKS},
+        {"DrainLong", plain<DrainAnimation>(), make_config(red, 600), nullptr, CASE_LONG_TICKS},
+        {"DrainIrregular", plain<DrainAnimation>(), make_config(red, 600), nullptr, CASE_IRREGULAR_TICKS},
+        {"WaterfallLong", plain<WaterfallAnimation>(), make_config(red, 1500), nullptr, CASE_LONG_TICKS},
+        {"WaterfallIrregular", plain<WaterfallAnimation>(), make_config(red, 1500), nullptr, CASE_IRREGULAR_TICKS},
+        {"FeedbackRainbow", plain<FeedbackRainbowAnimation>(1500u), make_config(red, 1000), nullptr},
+        {"PartyRainbowFade",
+         [](PartyModeState *s) -> Animation * { return new PartyRainbowFadeAnimation(s); },
+         make_config(red, 1000), drive_rainbow},
+        {"PartyRandomSparkle",
+         [](PartyModeState *s) -> Animation * { return new PartyRandomSparkleAnimation(s, 1); },
+         make_config(red, 1000), drive_sparkle},
+        {"BeatMeter",
+         [](PartyModeState *s) -> Animation * { return new BeatMeterAnimation(s); },
+         make_config(red, 1000), drive_beat_meter},
+    };
+}
+
+/** @brief The period of tick `tick` of case `c` (ms). */
+static inline uint32_t case_tick_ms(const AnimationCase &c, int tick) {
+    if (c.tick_ms.empty()) {
+        return CASE_TICK_MS;
+    }
+    return c.tick_ms[tick % c.tick_ms.size()];
+}
+
+/**
+ * @brief A case started at one ring size, from a fresh clock.
+ * @details Construct, then for every tick call `before_tick()`, advance the
+ *          host clock by `tick_ms()` and call `anim->update()` with it. The
+ *          frame is in `leds()` afterwards.
+ */
+class AnimationCaseRun {
+public:
+    AnimationCaseRun(const AnimationCase &c, int n) : c_(c), n_(n) {
+        host_clock_reset();
+        srand(1); // PartyRandomSparkleAnimation picks its pixel with rand()
+        g_cyclotron_led_count = (uint8_t)n;
+        fill_solid(g_cyclotron_leds, NUM_LEDS_CYCLOTRON, CRGB::Black);
+        anim.reset(c.make(&party_));
+        AnimationConfig config = c.config;
+        config.leds = g_cyclotron_leds;
+        config.num_leds = n;
+        anim->start(config);
+    }
+
+    void before_tick(int tick) {
+        if (tick == CASE_COLOR_RAMP_TICK) {
+            anim->setColor(CRGB(40, 90, 255), 400);
+        }
+        if (tick == CASE_SPEED_RAMP_TICK) {
+            anim->setSpeed(c_.config.speed / 2, 400);
+        }
+        if (c_.drive) {
+            c_.drive(&party_, tick);
+        }
+    }
+
+    uint32_t tick_ms(int tick) const { return case_tick_ms(c_, tick); }
+
+    const CRGB *leds() const { return g_cyclotron_leds; }
+    int size() const { return n_; }
+
+    std::unique_ptr<Animation> anim;
+
+private:
+    const AnimationCase &c_;
+    int n_;
+    PartyModeState party_;
+};
+
+#endif // ANIMATION_CASES_H
@@ -0,0 +1,228 @@
+/**
+ * @file golden_frames.cpp
+ * @brief Golden-frame regression test for every `Animation` subclass.
+ * @details Runs every case in `animation_cases.h` at N = 4, 24, 32 and
+ *          40 LEDs for `CASE_TICKS` pack timer ticks. The N LEDs of every
+ *          frame are hashed with MurmurHash3 and the hashes are compared with `golden/<case>.txt`. Golden files are
+ *          run-length encoded: a line `N frame hash` means the frame
+ *          `frame` and every following frame up to the next line hash to
+ *          `hash`. A mismatch reports the first frame that differs.
+ *
+ *          A case with a tick schedule is also checked against the same
+ *          animation ticked every `CASE_TICK_MS`: until its colour ramp
+ *          starts, every frame, and whether the animation has finished,
+ *          must be what the on-time run shows at the same moment. The
+ *          frame hashes alone would also accept a wrong catch-up.
+ *
+ *          Usage: `golden_frames <golden dir> [--update] [case...]`
+ *
+ *          `--update` rewrites the golden files instead of checking them;
+ *          use it (or the `update_golden_frames` target) only for a change
+ *          that is meant to alter the output.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "fl/hash.h"
+#include "animation_cases.h"
+
+/** @brief Frame hashes of one case at one size, one per tick. */
+static std::vector<uint32_t> run_case(const AnimationCase &c, int n) {
+    AnimationCaseRun run(c, n);
+    std::vector<uint32_t> hashes;
+    for (int tick = 0; tick < CASE_TICKS; tick++) {
+        const uint32_t dt = run.tick_ms(tick);
+        run.before_tick(tick);
+        host_clock_advance_us(dt * 1000);
+        run.anim->update(dt);
+        hashes.push_back(fl::MurmurHash3_x86_32(run.leds(), n * sizeof(CRGB)));
+    }
+    return hashes;
+}
+
+/** @brief One frame of a run: its hash and whether the animation was done. */
+struct CaseFrame {
+    uint32_t hash;
+    bool done;
+};
+
+/**
+ * @brief Checks a scheduled case's catch-up against an on-time run.
+ * @details Neither run starts a ramp, so the step count at a moment does
+ *          not depend on how the time up to it was cut into ticks.
+ */
+static bool check_catch_up(const AnimationCase &c, int n) {
+    uint32_t total_ms = 0;
+    for (int tick = 0; tick < CASE_COLOR_RAMP_TICK; tick++) {
+        total_ms += case_tick_ms(c, tick);
+    }
+
+    std::vector<CaseFrame> on_time(total_ms / CASE_TICK_MS + 1);
+    {
+        AnimationCase plain_case = c;
+        plain_case.tick_ms.clear();
+        AnimationCaseRun run(plain_case, n);
+        for (uint32_t t = CASE_TICK_MS; t <= total_ms; t += CASE_TICK_MS) {
+            host_clock_advance_us(CASE_TICK_MS * 1000);
+            run.anim->update(CASE_TICK_MS);
+            on_time[t / CASE_TICK_MS] = {fl::MurmurHash3_x86_32(run.leds(), n * sizeof(CRGB)),
+                                         run.anim->isDone()};
+        }
+    }
+
+    AnimationCaseRun run(c, n);
+    uint32_t t = 0;
+    for (int tick = 0; tick < CASE_COLOR_RAMP_TICK; tick++) {
+        const uint32_t dt = run.tick_ms(tick);
+        host_clock_advance_us(dt * 1000);
+        run.anim->update(dt);
+        t += dt;
+        if (t % CASE_TICK_MS != 0) {
+            continue;
+        }
+        const uint32_t hash = fl::MurmurHash3_x86_32(run.leds(), n * sizeof(CRGB));
+        const CaseFrame &want = on_time[t / CASE_TICK_MS];
+        if (hash != want.hash || run.anim->isDone() != want.done) {
+            printf("FAIL %s N=%d: frame %d at %u ms differs from the %u ms run%s\n", c.name, n,
+                   tick, (unsigned)t, (unsigned)CASE_TICK_MS,
+                   run.anim->isDone() != want.done ? " (done differs)" : "");
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string golden_path(const std::string &dir, const AnimationCase &c) {
+    return dir + "/" + c.name + ".txt";
+}
+
+static bool write_golden(const std::string &path,
+                         const std::vector<std::vector<uint32_t>> &runs) {
+    FILE *f = fopen(path.c_str(), "w");
+    if (!f) {
+        return false;
+    }
+    fprintf(f, "# N frame hash; each hash holds until the next line's frame\n");
+    for (size_t s = 0; s < runs.size(); s++) {
+        const std::vector<uint32_t> &h = runs[s];
+        for (size_t i = 0; i < h.size(); i++) {
+            if (i == 0 || h[i] != h[i - 1]) {
+                fprintf(f, "%d %zu %08x\n", CASE_SIZES[s], i, (unsigned)h[i]);
+            }
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+/** @brief Expands a golden file back into per-frame hashes for size `n`. */
+static bool read_golden(const std::string &path, int n, std::vector<uint32_t> *out) {
+    FILE *f = fopen(path.c_str(), "r");
+    if (!f) {
+        return false;
+    }
+    out->assign(CASE_TICKS, 0);
+    char line[128];
+    int last_frame = -1;
+    uint32_t last_hash = 0;
+    while (fgets(line, sizeof(line), f)) {
+        int size, frame;
+        unsigned hash;
+        if (line[0] == '#' || sscanf(line, "%d %d %x", &size, &frame, &hash) != 3 ||
+            size != n || frame < 0 || frame >= CASE_TICKS) {
+            continue;
+        }
+        for (int i = last_frame; i >= 0 && i < frame; i++) {
+            (*out)[i] = last_hash;
+        }
+        last_frame = frame;
+        last_hash = hash;
+    }
+    fclose(f);
+    if (last_frame < 0) {
+        return false;
+    }
+    for (int i = last_frame; i < CASE_TICKS; i++) {
+        (*out)[i] = last_hash;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: golden_frames <golden dir> [--update] [case...]\n");
+        return 2;
+    }
+    const std::string dir = argv[1];
+    bool update = false;
+    std::vector<std::string> only;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else {
+            only.push_back(argv[i]);
+        }
+    }
+
+    int failures = 0;
+    int checked = 0;
+    for (const AnimationCase &c : animation_cases()) {
+        if (!only.empty() && std::find(only.begin(), only.end(), c.name) == only.end()) {
+            continue;
+        }
+        std::vector<std::vector<uint32_t>> runs;
+        for (int n : CASE_SIZES) {
+            runs.push_back(run_case(c, n));
+        }
+
+        const std::string path = golden_path(dir, c);
+        if (update) {
+            if (!write_golden(path, runs)) {
+                fprintf(stderr, "cannot write %s\n", path.c_str());
+                return 1;
+            }
+            printf("updated %s\n", path.c_str());
+            continue;
+        }
+
+        for (size_t s = 0; s < runs.size(); s++) {
+            const int n = CASE_SIZES[s];
+            std::vector<uint32_t> expected;
+            checked++;
+            if (!read_golden(path, n, &expected)) {
+                printf("FAIL %s N=%d: no golden hashes in %s\n", c.name, n, path.c_str());
+                failures++;
+                continue;
+            }
+            bool match = true;
+            for (int i = 0; i < CASE_TICKS && match; i++) {
+                if (runs[s][i] != expected[i]) {
+                    printf("FAIL %s N=%d: frame %d hashes to %08x, golden %08x\n",
+                           c.name, n, i, (unsigned)runs[s][i], (unsigned)expected[i]);
+                    match = false;
+                }
+            }
+            if (match && !c.tick_ms.empty()) {
+                match = check_catch_up(c, n);
+            }
+            if (!match) {
+                failures++;
+            }
+        }
+    }
+
+    if (!update) {
+        printf("%d of %d case/size runs match their golden frames\n",
+               checked - failures, checked);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file layer_compositing.cpp
+ * @brief Checks how `AnimationController` puts its layers on the strip.
+ * @details Each check drives a controller on an 8 LED buffer with
+ *          `PaintAnimation`, which fills the strip once when it starts and
+ *          never draws again, so any pixel the controller fails to give back
+ *          to the base stays visible. A check prints a `FAIL` line naming the
+ *          step and LED that differ.
+ *
+ *          Usage: `layer_compositing`
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include <stdio.h>
+
+#include "animation_controller.h"
+
+static const int kLeds = 8;
+static const CRGB kRed(200, 0, 0);
+static const CRGB kGreen(0, 200, 0);
+static const CRGB kBlue(0, 0, 200);
+static const CRGB kWhite(200, 200, 200);
+
+/** @brief Fills the strip with its colour on start and then leaves it alone. */
+class PaintAnimation : public Animation {
+public:
+    void start(const AnimationConfig& config) override {
+        Animation::start(config);
+        fill_solid(config.leds, config.num_leds, config.color);
+    }
+    bool isDone() override { return false; }
+};
+
+static CRGB leds[kLeds];
+static int failures = 0;
+
+static AnimationConfig paint(const CRGB& color) {
+    AnimationConfig config;
+    config.leds = leds;
+    config.num_leds = kLeds;
+    config.color = color;
+    return config;
+}
+
+/** @brief Checks LEDs `from` to `to - 1` against `want`. */
+static void expect(const char *step, int from, int to, const CRGB& want) {
+    for (int i = from; i < to; i++) {
+        if (leds[i] != want) {
+            printf("FAIL %s: LED %d is (%d,%d,%d), expected (%d,%d,%d)\n", step, i,
+                   leds[i].r, leds[i].g, leds[i].b, want.r, want.g, want.b);
+            failures++;
+            return;
+        }
+    }
+}
+
+static void new_base_under_overlay() {
+    AnimationController c;
+    c.play<PaintAnimation>(paint(kRed));
+    c.playOverlay<PaintAnimation>(paint(kBlue), LAYER_BLEND_MAX, 255);
+    c.update(4);
+    expect("base under overlay", 0, kLeds, CRGB(200, 0, 200));
+    c.play<PaintAnimation>(paint(kGreen));
+    c.update(4);
+    expect("new base under overlay", 0, kLeds, CRGB(0, 200, 200));
+    c.stopOverlay();
+    c.update(4);
+    expect("new base after overlay", 0, kLeds, kGreen);
+}
+
+static void new_overlay_over_overlay() {
+    AnimationController c;
+    c.play<PaintAnimation>(paint(kRed));
+    c.playOverlay<PaintAnimation>(paint(kBlue), LAYER_BLEND_ALPHA, 255);
+    c.update(4);
+    expect("opaque overlay", 0, kLeds, kBlue);
+    c.playOverlay<PaintAnimation>(paint(kGreen), LAYER_BLEND_ADD, 0);
+    c.update(4);
+    expect("hidden second overlay", 0, kLeds, kRed);
+}
+
+static void stop_leaves_base() {
+    AnimationController c;
+    c.play<PaintAnimation>(paint(kRed));
+    c.playOverlay<PaintAnimation>(paint(kBlue), LAYER_BLEND_ALPHA, 255);
+    c.update(4);
+    c.stop();
+    expect("stopped", 0, kLeds, kRed);
+    c.update(4);
+    expect("after stop", 0, kLeds, kRed);
+}
+
+static void direct_write_under_overlay() {
+    AnimationController c;
+    c.play<PaintAnimation>(paint(kRed));
+    c.playOverlay<PaintAnimation>(paint(kBlue), LAYER_BLEND_ALPHA, 128);
+    c.update(4);
+    fill_solid(leds, 2, kWhite);
+    c.update(4);
+    expect("direct write blended", 0, 2, CRGB::blend(kWhite, kBlue, 128));
+    expect("base blended", 2, kLeds, CRGB::blend(kRed, kBlue, 128));
+    c.stopOverlay();
+    c.update(4);
+    expect("direct write kept", 0, 2, kWhite);
+    expect("base kept", 2, kLeds, kRed);
+}
+
+static void mask_over_overlay() {
+    static volatile uint8_t active = 4;
+    AnimationController c;
+    c.setMask(leds, kLeds, &active);
+    c.play<PaintAnimation>(paint(kRed));
+    c.playOverlay<PaintAnimation>(paint(kBlue), LAYER_BLEND_ALPHA, 255);
+    c.update(4);
+    expect("masked overlay", 0, 4, kBlue);
+    expect("masked off", 4, kLeds, CRGB::Black);
+}
+
+int main() {
+    new_base_under_overlay();
+    new_overlay_over_overlay();
+    stop_leaves_base();
+    direct_write_under_overlay();
+    mask_over_overlay();
+    if (!failures) {
+        printf("all layer checks pass\n");
+    }
+    return failures ? 1 : 0;
+}
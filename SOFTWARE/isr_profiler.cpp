@@ -0,0 +1,165 @@
+/**
+ * @file isr_profiler.cpp
+ * @brief Per-stage timing of the pack timer ISR.
+ * @details Each stage owns a ring of its most recent durations. Recording is
+ *          a store and an increment so it adds next to nothing to the pass
+ *          being measured; all sorting and arithmetic happens when the table
+ *          is read from the main loop. A reader may see a sample the ISR is
+ *          overwriting, which is harmless for statistics.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "isr_profiler.h"
+#include "pack_config.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef KLYSTRON_ISR_PROFILE
+
+#ifdef KLYSTRON_HOST_BUILD
+#include <chrono>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef KLYSTRON_HOST_BUILD
+/** @brief Profiler ticks per microsecond: nanoseconds on the host. */
+#define ISR_PROFILE_TICKS_PER_US 1000u
+static inline uint32_t isr_profile_now(void) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+#else
+/** @brief Profiler ticks per microsecond: the hardware timer's resolution. */
+#define ISR_PROFILE_TICKS_PER_US 1u
+static inline uint32_t isr_profile_now(void) { return time_us_32(); }
+#endif
+
+static const char *const s_stage_names[ISR_STAGE_COUNT] = {
+    "inputs",  "powercell", "cyclotron", "future", "party", "heat",
+    "monster", "sound",     "show",      "total",  "period"};
+
+static volatile uint32_t s_ring[ISR_STAGE_COUNT][ISR_PROFILE_RING];
+static volatile uint32_t s_written[ISR_STAGE_COUNT];
+static volatile uint32_t s_worst[ISR_STAGE_COUNT];
+static volatile uint32_t s_over_budget = 0;
+static uint32_t s_pass_start = 0;
+static uint32_t s_last_mark = 0;
+static bool s_have_pass = false;
+
+static inline void record(IsrStage stage, uint32_t ticks) {
+    uint32_t n = s_written[stage];
+    s_ring[stage][n % ISR_PROFILE_RING] = ticks;
+    s_written[stage] = n + 1;
+    if (ticks > s_worst[stage]) {
+        s_worst[stage] = ticks;
+    }
+}
+
+void isr_profile_begin(void) {
+    uint32_t now = isr_profile_now();
+    if (s_have_pass) {
+        record(ISR_STAGE_PERIOD, now - s_pass_start);
+    }
+    s_have_pass = true;
+    s_pass_start = now;
+    s_last_mark = now;
+}
+
+void isr_profile_mark(IsrStage stage) {
+    uint32_t now = isr_profile_now();
+    record(stage, now - s_last_mark);
+    s_last_mark = now;
+}
+
+void isr_profile_end(void) {
+    uint32_t total = s_last_mark - s_pass_start;
+    record(ISR_STAGE_TOTAL, total);
+    if (total > pack_isr_interval_ms * 1000u * ISR_PROFILE_TICKS_PER_US) {
+        s_over_budget = s_over_budget + 1;
+    }
+}
+
+void isr_profile_reset(void) {
+    for (int i = 0; i < ISR_STAGE_COUNT; i++) {
+        s_written[i] = 0;
+        s_worst[i] = 0;
+    }
+    s_over_budget = 0;
+    s_have_pass = false;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+bool isr_profile_stats(IsrStage stage, IsrStageStats *out) {
+    static uint32_t sorted[ISR_PROFILE_RING];
+    uint32_t n = s_written[stage];
+    if (n > ISR_PROFILE_RING) {
+        n = ISR_PROFILE_RING;
+    }
+    if (n == 0) {
+        return false;
+    }
+
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sorted[i] = s_ring[stage][i];
+        sum += sorted[i];
+    }
+    qsort(sorted, n, sizeof(sorted[0]), compare_u32);
+
+    const float scale = 1.0f / ISR_PROFILE_TICKS_PER_US;
+    uint32_t rank = (n * 99 + 99) / 100; // ceil(0.99 * n), 1-based
+    out->samples = n;
+    out->min_us = sorted[0] * scale;
+    out->max_us = sorted[n - 1] * scale;
+    out->mean_us = (float)sum / n * scale;
+    out->p99_us = sorted[rank - 1] * scale;
+    out->worst_us = s_worst[stage] * scale;
+    return true;
+}
+
+uint32_t isr_profile_over_budget(void) { return s_over_budget; }
+
+void isr_profile_dump(void) {
+    printf("pack_timer_isr profile (last %u passes, us)\n",
+           (unsigned)ISR_PROFILE_RING);
+    printf("%-10s %5s %9s %9s %9s %9s %9s\n", "stage", "n", "min", "max",
+           "mean", "p99", "worst");
+    for (int i = 0; i < ISR_STAGE_COUNT; i++) {
+        IsrStageStats st;
+        if (!isr_profile_stats((IsrStage)i, &st)) {
+            continue;
+        }
+        printf("%-10s %5u %9.3f %9.3f %9.3f %9.3f %9.3f\n", s_stage_names[i],
+               (unsigned)st.samples, st.min_us, st.max_us, st.mean_us,
+               st.p99_us, st.worst_us);
+    }
+    printf("passes over the %u ms budget: %u\n",
+           (unsigned)pack_isr_interval_ms, (unsigned)s_over_budget);
+}
+
+void isr_profile_service(void) {
+    static uint32_t last_dump_ms = 0;
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    if (now_ms - last_dump_ms >= ISR_PROFILE_DUMP_MS) {
+        last_dump_ms = now_ms;
+        isr_profile_dump();
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KLYSTRON_ISR_PROFILE
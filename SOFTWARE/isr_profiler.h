@@ -0,0 +1,111 @@
+/**
+ * @file isr_profiler.h
+ * @brief Per-stage timing of the pack timer ISR.
+ * @details When built with `KLYSTRON_ISR_PROFILE` defined, `pack_timer_isr`
+ *          timestamps the end of each of its stages and this module keeps
+ *          the most recent `ISR_PROFILE_RING` durations of every stage,
+ *          together with the pass-to-pass period. `isr_profile_dump()`
+ *          prints min/max/mean/p99 over that window. Without the define the
+ *          `ISR_PROFILE_*` macros compile to nothing and the ISR is
+ *          unchanged.
+ *
+ *          Samples are taken with `time_us_32()` on the board. The host
+ *          build's clock is simulated and does not move inside the ISR, so
+ *          there the profiler reads the machine's monotonic clock instead.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef ISR_PROFILER_H
+#define ISR_PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of samples kept per stage. */
+#ifndef ISR_PROFILE_RING
+#define ISR_PROFILE_RING 256
+#endif
+
+/** @brief How often `isr_profile_service()` prints the table, in ms. */
+#ifndef ISR_PROFILE_DUMP_MS
+#define ISR_PROFILE_DUMP_MS 5000
+#endif
+
+/**
+ * @brief The measured stages of `pack_timer_isr`, in execution order.
+ */
+typedef enum {
+    ISR_STAGE_INPUTS = 0, /**< DIP and user switch polling. */
+    ISR_STAGE_POWERCELL,  /**< Powercell controller update. */
+    ISR_STAGE_CYCLOTRON,  /**< Cyclotron controller update. */
+    ISR_STAGE_FUTURE,     /**< Future controller update. */
+    ISR_STAGE_PARTY,      /**< `party_mode_run`. */
+    ISR_STAGE_HEAT,       /**< `heat_isr`. */
+    ISR_STAGE_MONSTER,    /**< `monster_isr`. */
+    ISR_STAGE_SOUND,      /**< `sound_isr`. */
+    ISR_STAGE_SHOW,       /**< `show_leds`. */
+    ISR_STAGE_TOTAL,      /**< The whole pass. */
+    ISR_STAGE_PERIOD,     /**< Start of one pass to the start of the next. */
+    ISR_STAGE_COUNT
+} IsrStage;
+
+/** @brief Summary of one stage over the current window, in µs. */
+typedef struct {
+    uint32_t samples; /**< Samples in the window (at most ISR_PROFILE_RING). */
+    float min_us;
+    float max_us;
+    float mean_us;
+    float p99_us;     /**< Nearest-rank 99th percentile. */
+    float worst_us;   /**< Longest ever seen, including evicted samples. */
+} IsrStageStats;
+
+/** @brief Marks the start of an ISR pass. */
+void isr_profile_begin(void);
+
+/** @brief Marks the end of a stage; its duration runs from the previous mark. */
+void isr_profile_mark(IsrStage stage);
+
+/** @brief Marks the end of an ISR pass. */
+void isr_profile_end(void);
+
+/** @brief Discards every sample. */
+void isr_profile_reset(void);
+
+/**
+ * @brief Summarises one stage over the current window.
+ * @return false if the stage has no samples yet.
+ */
+bool isr_profile_stats(IsrStage stage, IsrStageStats *out);
+
+/** @brief Returns the number of passes whose total exceeded the ISR interval. */
+uint32_t isr_profile_over_budget(void);
+
+/** @brief Prints the per-stage table to stdio. */
+void isr_profile_dump(void);
+
+/**
+ * @brief Prints the table every `ISR_PROFILE_DUMP_MS`; call from the main loop.
+ */
+void isr_profile_service(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef KLYSTRON_ISR_PROFILE
+#define ISR_PROFILE_BEGIN() isr_profile_begin()
+#define ISR_PROFILE_MARK(stage) isr_profile_mark(stage)
+#define ISR_PROFILE_END() isr_profile_end()
+#else
+#define ISR_PROFILE_BEGIN() ((void)0)
+#define ISR_PROFILE_MARK(stage) ((void)0)
+#define ISR_PROFILE_END() ((void)0)
+#endif
+
+#endif // ISR_PROFILER_H
@@ -21,10 +21,14 @@
 #include "hardware/gpio.h"
 
 // Firmware includes
+#include "klystron.h"
+#include "isr_profiler.h"
 #include "addressable_LED_support.h"
 #include "powercell_sequences.h"
 #include "cyclotron_sequences.h"
 #include "animation_controller.h"
+#include "animation_clock.h"
+#include "led_core.h"
 #include "future_sequences.h"
 #include "party_sequences.h"
 #include "klystron_IO_support.h"
@@ -33,6 +37,7 @@
 #include "monster.h"
 #include "led_patterns.h"
 #include "sound.h"
+#include "sound_module.h"
 #include "pack_state.h"
 #include "monitors.h"
 #include "pack_config.h"
@@ -47,64 +52,89 @@ AnimationController g_future_controller;
  * @details This function is the main heartbeat of the firmware. It's called
  *          by a repeating timer every `pack_isr_interval_ms`. It is responsible
  *          for polling inputs, advancing all animation patterns, and updating
- *          timers.
+ *          timers. In dual-core mode the animation and LED output stages move
+ *          to core1 once `led_core_start` has run (see `led_core.h`).
  * @param t Pointer to the repeating_timer structure.
  * @return true to continue the timer, false to stop it.
  */
 bool pack_timer_isr(struct repeating_timer *t) {
+    ISR_PROFILE_BEGIN();
+
     // Poll hardware inputs
     check_dip_switches_isr();
     check_user_switches_isr();
-
-    // Ensure any LEDs above the active count remain dark before animations run.
-    // mask_cyclotron_leds();
-
-    // Advance animation patterns
-    g_powercell_controller.update(pack_isr_interval_ms);
-    g_cyclotron_controller.update(pack_isr_interval_ms);
-    g_future_controller.update(pack_isr_interval_ms);
-    party_mode_run();
+    ISR_PROFILE_MARK(ISR_STAGE_INPUTS);
+
+    // Advance animation patterns by the time that really passed, unless
+    // core1 has taken them over
+    if (!led_core_active()) {
+        const uint32_t dt = animation_clock_tick();
+        g_powercell_controller.update(dt);
+        ISR_PROFILE_MARK(ISR_STAGE_POWERCELL);
+        g_cyclotron_controller.update(dt);
+        ISR_PROFILE_MARK(ISR_STAGE_CYCLOTRON);
+        g_future_controller.update(dt);
+        ISR_PROFILE_MARK(ISR_STAGE_FUTURE);
+        party_mode_run();
+        ISR_PROFILE_MARK(ISR_STAGE_PARTY);
+    }
 
     // Update timers and other modules
     heat_isr();
+    ISR_PROFILE_MARK(ISR_STAGE_HEAT);
     monster_isr();
+    ISR_PROFILE_MARK(ISR_STAGE_MONSTER);
+
+    // Send any held sound stop and report BUSY edges
+    sound_isr();
+    ISR_PROFILE_MARK(ISR_STAGE_SOUND);
 
     // Push updated LED state to the physical strips
-    show_leds();
+    if (!led_core_active()) {
+        show_leds();
+        ISR_PROFILE_MARK(ISR_STAGE_SHOW);
+    }
+
+    ISR_PROFILE_END();
     return true;
 }
 
 /**
  * @brief Initializes the repeating timer used for pack updates.
- * @note The delay is positive, which the SDK defines as the gap between one
- *       callback ending and the next starting rather than a fixed period. The
- *       callback also drives the LED output, and FastLED caps the RP2040
- *       clockless driver at 400 Hz with a busy-wait, so the real interval
- *       between two passes is `pack_isr_interval_ms` plus however long the
- *       previous pass took. Anything that has to measure a real duration must
- *       therefore read the hardware timer rather than count callbacks - see
- *       the FIRE input timing in `klystron_IO_support.cpp`.
+ * @note The delay is negative, which the SDK defines as a fixed period
+ *       between callback starts. `show_leds` only starts DMA transfers and
+ *       never waits on the wire, so a pass stays well inside
+ *       `pack_isr_interval_ms` regardless of LED count. Anything that has to
+ *       measure a real duration should still read the hardware timer rather
+ *       than count callbacks - see the FIRE input timing in
+ *       `klystron_IO_support.cpp`.
  */
 void init_pack_timer(void) {
     static struct repeating_timer timer;
-    add_repeating_timer_ms(pack_isr_interval_ms, pack_timer_isr, NULL, &timer);
+    animation_clock_reset();
+    add_repeating_timer_ms(-(int32_t)pack_isr_interval_ms, pack_timer_isr, NULL, &timer);
 }
 
 /**
- * @brief Main application entry point.
- * @details This function performs all one-time initializations for hardware
- *          and software modules. It checks for the special board test mode
- *          entry condition. If not in test mode, it initializes the main pack
- *          state machine and enters an infinite loop to process it.
- * @return 0 on successful execution (though it should never return).
+ * @brief Performs all one-time hardware and software initialization.
+ * @details Initializes every hardware and software module, checks for the
+ *          special board test mode entry condition and, once any board test
+ *          has finished, initializes the main pack state machine.
  */
-int main(void) {
+void klystron_init(void) {
     static bool board_test_done = false;
 
+#if defined(KLYSTRON_ISR_PROFILE) && !defined(KLYSTRON_HOST_BUILD)
+    // The profile table is printed over USB; UART0 belongs to the sound board.
+    stdio_init_all();
+#endif
+
     // Hardware and software initializations
     init_gpio();
     init_adc();
     init_leds();
+    // LEDs past the active ring size stay dark, whatever is drawn there
+    g_cyclotron_controller.setMask(g_cyclotron_leds, NUM_LEDS_CYCLOTRON, &g_cyclotron_led_count);
     init_pack_timer();
 
     // Set initial cyclotron ring size from the potentiometer
@@ -123,13 +153,34 @@ int main(void) {
         board_test_done = true;
     }
 
+#ifdef KLYSTRON_DUAL_CORE
+    // Hand the animation controllers and LED output to core1
+    led_core_start();
+#endif
+
     // Initialize the main state machine
     pack_state_init();
+}
+
+#ifndef KLYSTRON_HOST_BUILD
+/**
+ * @brief Main application entry point.
+ * @details Runs the one-time initialization and then enters an infinite loop
+ *          to process the main pack state machine. The host build supplies
+ *          its own entry point (see `host/host_main.cpp`).
+ * @return 0 on successful execution (though it should never return).
+ */
+int main(void) {
+    klystron_init();
 
     // Main application loop
     while (true) {
         pack_state_process();
+#ifdef KLYSTRON_ISR_PROFILE
+        isr_profile_service();
+#endif
     }
 
     return 0;
 }
+#endif // KLYSTRON_HOST_BUILD
@@ -0,0 +1,37 @@
+/**
+ * @file klystron.h
+ * @brief Top-level entry points of the Klystron firmware.
+ * @details Exposes the start-up sequence and the pack timer ISR so that
+ *          builds other than the RP2040 image, such as the host build, can
+ *          drive the same code that `main` does.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef KLYSTRON_H
+#define KLYSTRON_H
+
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+/**
+ * @brief Repeating timer interrupt handler.
+ * @param t Pointer to the repeating_timer structure.
+ * @return true to continue the timer, false to stop it.
+ */
+bool pack_timer_isr(struct repeating_timer *t);
+
+/**
+ * @brief Initializes the repeating timer used for pack updates.
+ */
+void init_pack_timer(void);
+
+/**
+ * @brief Performs all one-time hardware and software initialization.
+ * @details Everything `main` does before entering the state machine loop,
+ *          including the board test entry check.
+ */
+void klystron_init(void);
+
+#endif // KLYSTRON_H
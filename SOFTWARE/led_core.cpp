@@ -0,0 +1,145 @@
+/**
+ * @file led_core.cpp
+ * @brief Second-core LED loop and its command FIFO.
+ * @details See `led_core.h`. The FIFO is a ring of `LedCoreCommand` slots
+ *          with one index per side: core0 alone writes `fifo_tail` and core1
+ *          alone writes `fifo_head`, so neither side needs a lock or an
+ *          atomic read-modify-write, which the RP2040's Cortex-M0+ cores do
+ *          not have.
+ *
+ *          The host build has no second core. There the loop runs from its
+ *          own repeating timer on the simulated clock, which fires whenever
+ *          the state machine sleeps or spins, just as core1 would keep going.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifdef KLYSTRON_DUAL_CORE
+
+#include <atomic>
+#include <cstddef>
+
+#include "pico/stdlib.h"
+#ifndef KLYSTRON_HOST_BUILD
+#include "pico/multicore.h"
+#endif
+
+#include "led_core.h"
+#include "animation_clock.h"
+#include "addressable_LED_support.h"
+#include "party_sequences.h"
+#include "pack_state.h"
+#include "pack_config.h"
+
+static_assert((LED_CORE_FIFO_DEPTH & (LED_CORE_FIFO_DEPTH - 1)) == 0,
+              "LED_CORE_FIFO_DEPTH must be a power of two");
+
+alignas(std::max_align_t) static unsigned char
+    fifo_slots[LED_CORE_FIFO_DEPTH][sizeof(LedCoreCommand)];
+static std::atomic<uint32_t> fifo_head(0); // next slot core1 runs
+static std::atomic<uint32_t> fifo_tail(0); // next slot core0 fills
+
+static volatile bool led_core_running = false;
+
+#ifdef KLYSTRON_HOST_BUILD
+// Set while the host timer is standing in for core1.
+static bool on_led_core = false;
+#endif
+
+bool led_core_active(void) {
+    return led_core_running;
+}
+
+bool led_core_is_current(void) {
+#ifdef KLYSTRON_HOST_BUILD
+    return on_led_core;
+#else
+    return get_core_num() == 1;
+#endif
+}
+
+void *led_core_reserve(void) {
+    uint32_t tail = fifo_tail.load(std::memory_order_relaxed);
+    // Full: wait for core1 to run the oldest command.
+    while (tail - fifo_head.load(std::memory_order_acquire) == LED_CORE_FIFO_DEPTH) {
+        tight_loop_contents();
+    }
+    return fifo_slots[tail & (LED_CORE_FIFO_DEPTH - 1)];
+}
+
+void led_core_publish(void) {
+    fifo_tail.store(fifo_tail.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+}
+
+/**
+ * @brief Runs and destroys every command core0 has published so far.
+ */
+static void led_core_drain(void) {
+    uint32_t head = fifo_head.load(std::memory_order_relaxed);
+    uint32_t tail = fifo_tail.load(std::memory_order_acquire);
+    while (head != tail) {
+        LedCoreCommand *cmd = reinterpret_cast<LedCoreCommand *>(
+            fifo_slots[head & (LED_CORE_FIFO_DEPTH - 1)]);
+        (*cmd)();
+        cmd->~LedCoreCommand();
+        head++;
+        // Hand the slot back as soon as it is free.
+        fifo_head.store(head, std::memory_order_release);
+    }
+}
+
+void led_core_frame(void) {
+    led_core_drain();
+
+    const uint32_t dt = animation_clock_tick();
+    g_powercell_controller.update(dt);
+    g_cyclotron_controller.update(dt);
+    g_future_controller.update(dt);
+    party_mode_run();
+
+    show_leds();
+}
+
+#ifdef KLYSTRON_HOST_BUILD
+
+static bool led_core_timer(struct repeating_timer *t) {
+    on_led_core = true;
+    led_core_frame();
+    on_led_core = false;
+    return true;
+}
+
+void led_core_start(void) {
+    static struct repeating_timer timer;
+    led_core_running = true;
+    add_repeating_timer_ms(-(int32_t)pack_isr_interval_ms, led_core_timer, NULL, &timer);
+}
+
+#else
+
+/**
+ * @brief Core1 entry point: one LED frame every `pack_isr_interval_ms`.
+ * @details Deadlines advance by a fixed step from the first frame, so a long
+ *          frame is made up by a shorter sleep rather than shifting every
+ *          frame after it.
+ */
+static void led_core_main(void) {
+    absolute_time_t next = get_absolute_time();
+    while (true) {
+        led_core_frame();
+        next = delayed_by_ms(next, pack_isr_interval_ms);
+        sleep_until(next);
+    }
+}
+
+void led_core_start(void) {
+    // The timer ISR checks this flag, so from here on it leaves the LEDs alone.
+    led_core_running = true;
+    multicore_launch_core1(led_core_main);
+}
+
+#endif // KLYSTRON_HOST_BUILD
+
+#endif // KLYSTRON_DUAL_CORE
@@ -0,0 +1,105 @@
+/**
+ * @file led_core.h
+ * @brief Optional second-core LED pipeline.
+ * @details Built with `KLYSTRON_DUAL_CORE`, the three animation controllers,
+ *          `party_mode_run` and `show_leds` move off the pack timer ISR and
+ *          onto core1, which runs them in a fixed-rate loop every
+ *          `pack_isr_interval_ms`. Animation timing then no longer depends
+ *          on what the state machine is blocked on.
+ *
+ *          Core0 reaches LED state only through `led_core_call()`, which
+ *          copies a closure into a lock-free single-producer/single-consumer
+ *          FIFO in shared RAM. Core1 drains the FIFO in order at the start of
+ *          every frame. `AnimationController` routes `play`, `enqueue`,
+ *          `stop` and `modify` through it, so state machine code does not
+ *          change. Code that core1 runs itself, such as actions and their
+ *          callbacks, goes straight through. For the same reason a
+ *          `CallbackAction` may only touch LED state: the sound driver, the
+ *          speed ramps and the pack state belong to core0, so sequences that
+ *          need them step from the state machine instead.
+ *
+ *          Without `KLYSTRON_DUAL_CORE`, `led_core_call()` runs the closure
+ *          in place and the timer ISR keeps driving the LEDs as before.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef LED_CORE_H
+#define LED_CORE_H
+
+#include <stdbool.h>
+#include <utility>
+#include "action.h"
+
+/** @brief Commands that can wait in the FIFO at once. */
+#define LED_CORE_FIFO_DEPTH 32
+
+/** @brief Bytes of captured state one command can hold: enough for a `play`. */
+#define LED_CORE_COMMAND_CAPACITY (sizeof(AnimationConfig) + 6 * sizeof(void *))
+
+/** @brief A queued closure, stored in its FIFO slot. */
+typedef InplaceCallback<LED_CORE_COMMAND_CAPACITY> LedCoreCommand;
+
+#ifdef KLYSTRON_DUAL_CORE
+
+/**
+ * @brief Starts the LED loop on core1.
+ * @details Called once from `klystron_init` after the board test. Until then
+ *          the timer ISR keeps driving the LEDs and commands run in place.
+ */
+void led_core_start(void);
+
+/** @brief True once core1 owns the LED pipeline. */
+bool led_core_active(void);
+
+/** @brief True when called from the LED loop itself. */
+bool led_core_is_current(void);
+
+/**
+ * @brief Runs one LED frame: queued commands, controllers, party mode, output.
+ */
+void led_core_frame(void);
+
+/**
+ * @brief Reserves the next free FIFO slot, waiting for core1 if it is full.
+ * @details Only core0 may produce. The slot must be filled and then
+ *          published with `led_core_publish()`.
+ */
+void *led_core_reserve(void);
+
+/** @brief Makes the command built in the reserved slot visible to core1. */
+void led_core_publish(void);
+
+/** @brief True when LED work has to be queued rather than done here. */
+static inline bool led_core_defer(void) {
+    return led_core_active() && !led_core_is_current();
+}
+
+#else
+
+static inline bool led_core_active(void) { return false; }
+static inline bool led_core_is_current(void) { return true; }
+static inline bool led_core_defer(void) { return false; }
+
+#endif // KLYSTRON_DUAL_CORE
+
+/**
+ * @brief Runs `fn` wherever the LED state lives.
+ * @details On core0 in dual-core mode `fn` is copied into the command FIFO
+ *          and runs on core1 before its next frame, after every command
+ *          queued ahead of it. Everywhere else it runs immediately.
+ */
+template <typename F>
+void led_core_call(F &&fn) {
+#ifdef KLYSTRON_DUAL_CORE
+    if (led_core_defer()) {
+        new (led_core_reserve()) LedCoreCommand(std::forward<F>(fn));
+        led_core_publish();
+        return;
+    }
+#endif
+    fn();
+}
+
+#endif // LED_CORE_H
@@ -1,21 +1,37 @@
 #include "RampCRGB.h"
 
-RampCRGB::RampCRGB(CRGB initialValue) {
-    r.go(initialValue.r);
-    g.go(initialValue.g);
-    b.go(initialValue.b);
+RampCRGB::RampCRGB(CRGB initialValue) : val(initialValue), A(initialValue), B(initialValue) {
 }
 
 void RampCRGB::go(CRGB target, unsigned long duration, ramp_mode mode) {
-    r.go(target.r, duration, mode);
-    g.go(target.g, duration, mode);
-    b.go(target.b, duration, mode);
+    A = val;
+    B = target;
+    start(duration, mode, ONCEFORWARD);
+    if (duration == 0) val = B;
 }
 
 CRGB RampCRGB::update() {
-    return CRGB(r.update(), g.update(), b.update());
+    return update(automated ? millis() : 0);
+}
+
+CRGB RampCRGB::update(uint32_t now) {
+    if (advance(now)) {
+        if (dur == 0 || A == B) {
+            val = B;
+        } else if (mode == LINEAR) {
+            val = CRGB(ramp_fixed_linear(A.r, B.r, pos, dur),
+                       ramp_fixed_linear(A.g, B.g, pos, dur),
+                       ramp_fixed_linear(A.b, B.b, pos, dur));
+        } else {
+            int32_t e = easing();
+            val = CRGB(ramp_fixed_lerp(A.r, B.r, e),
+                       ramp_fixed_lerp(A.g, B.g, e),
+                       ramp_fixed_lerp(A.b, B.b, e));
+        }
+    }
+    return val;
 }
 
 CRGB RampCRGB::getValue() {
-    return CRGB(r.getValue(), g.getValue(), b.getValue());
+    return val;
 }
@@ -2,16 +2,19 @@
 #define RAMPCRGB_H
 
 #include <FastLED.h>
-#include "Ramp.h"
+#include "RampFixed.h"
 
-class RampCRGB {
+// Colour ramp: the three channels share one position and easing value, so
+// an update costs one timing step and one curve evaluation.
+class RampCRGB : public rampFixedTimer {
 public:
     RampCRGB(CRGB initialValue);
     void go(CRGB target, unsigned long duration, ramp_mode mode = LINEAR);
     CRGB update();
+    CRGB update(uint32_t now);
     CRGB getValue();
 private:
-    rampFloat r, g, b;
+    CRGB val, A, B;
 };
 
 #endif // RAMPCRGB_H
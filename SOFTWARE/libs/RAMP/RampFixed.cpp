@@ -0,0 +1,373 @@
+// Fixed-point ramps for the RAMP library
+// Q16.16 versions of the ramp_calc() easing curves; see RampFixed.h.
+
+#include "RampFixed.h"
+
+#define RAMP_FIXED_LUT_SIZE 256
+#define RAMP_FIXED_HALF     (RAMP_FIXED_ONE / 2)
+
+/*-----------------------------
+ EASING TABLES
+ -----------------------------*/
+
+// Q16.16 samples of f(u) at u = i / 256, generated from the same formulas
+// as ramp_calc(). The elastic tables fold the phase offset s = p / 4 into a
+// cosine: -sin((u - 1 - s) * 2 * pi / p) == cos((u - 1) * 2 * pi / p).
+
+// sin(u * pi / 2)
+static const int32_t sine_lut[RAMP_FIXED_LUT_SIZE + 1] = {
+    0, 402, 804, 1206, 1608, 2010, 2412, 2814,
+    3216, 3617, 4019, 4420, 4821, 5222, 5623, 6023,
+    6424, 6824, 7224, 7623, 8022, 8421, 8820, 9218,
+    9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391,
+    12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+    15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+    19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699,
+    22078, 22457, 22834, 23210, 23586, 23961, 24335, 24708,
+    25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+    28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+    30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347,
+    33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+    36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716,
+    39040, 39362, 39683, 40002, 40320, 40636, 40951, 41264,
+    41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+    44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056,
+    46341, 46624, 46906, 47186, 47464, 47741, 48015, 48288,
+    48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+    50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398,
+    52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+    54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+    56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607,
+    57798, 57986, 58172, 58356, 58538, 58718, 58896, 59071,
+    59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+    60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+    61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596,
+    62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+    63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197,
+    64277, 64354, 64429, 64501, 64571, 64639, 64704, 64766,
+    64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+    65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436,
+    65457, 65476, 65492, 65505, 65516, 65525, 65531, 65535,
+    65536
+};
+
+// 2 ^ (10 * (u - 1))
+static const int32_t expo_lut[RAMP_FIXED_LUT_SIZE + 1] = {
+    64, 66, 68, 69, 71, 73, 75, 77,
+    79, 82, 84, 86, 89, 91, 93, 96,
+    99, 101, 104, 107, 110, 113, 116, 119,
+    123, 126, 129, 133, 137, 140, 144, 148,
+    152, 156, 161, 165, 170, 174, 179, 184,
+    189, 194, 200, 205, 211, 216, 222, 228,
+    235, 241, 248, 255, 262, 269, 276, 284,
+    292, 300, 308, 316, 325, 334, 343, 352,
+    362, 372, 382, 393, 403, 415, 426, 438,
+    450, 462, 475, 488, 501, 515, 529, 543,
+    558, 574, 589, 606, 622, 639, 657, 675,
+    693, 712, 732, 752, 773, 794, 816, 838,
+    861, 885, 909, 934, 960, 986, 1013, 1041,
+    1069, 1099, 1129, 1160, 1192, 1224, 1258, 1292,
+    1328, 1364, 1402, 1440, 1480, 1520, 1562, 1605,
+    1649, 1694, 1741, 1789, 1838, 1888, 1940, 1993,
+    2048, 2104, 2162, 2221, 2282, 2345, 2409, 2475,
+    2543, 2613, 2685, 2759, 2834, 2912, 2992, 3074,
+    3158, 3245, 3334, 3426, 3520, 3616, 3716, 3818,
+    3922, 4030, 4141, 4254, 4371, 4491, 4614, 4741,
+    4871, 5005, 5142, 5283, 5428, 5577, 5730, 5887,
+    6049, 6215, 6386, 6561, 6741, 6926, 7116, 7311,
+    7512, 7718, 7930, 8148, 8371, 8601, 8837, 9080,
+    9329, 9585, 9848, 10118, 10396, 10681, 10975, 11276,
+    11585, 11903, 12230, 12566, 12910, 13265, 13629, 14003,
+    14387, 14782, 15188, 15605, 16033, 16473, 16925, 17390,
+    17867, 18357, 18861, 19379, 19911, 20457, 21019, 21595,
+    22188, 22797, 23423, 24066, 24726, 25405, 26102, 26818,
+    27554, 28311, 29088, 29886, 30706, 31549, 32415, 33305,
+    34219, 35158, 36123, 37114, 38133, 39180, 40255, 41360,
+    42495, 43661, 44859, 46091, 47356, 48655, 49991, 51363,
+    52773, 54221, 55709, 57238, 58809, 60423, 62081, 63785,
+    65536
+};
+
+// ELASTIC_IN, period 0.45: 2 ^ (10 * (u - 1)) * cos((u - 1) * 2 * pi / 0.45)
+static const int32_t elastic_lut[RAMP_FIXED_LUT_SIZE + 1] = {
+    11, 15, 19, 23, 27, 32, 36, 41,
+    46, 50, 55, 60, 65, 70, 75, 80,
+    85, 90, 95, 100, 105, 109, 114, 118,
+    122, 126, 129, 133, 135, 138, 140, 142,
+    143, 144, 144, 144, 143, 142, 140, 137,
+    134, 130, 125, 119, 113, 106, 98, 90,
+    80, 70, 59, 47, 34, 21, 6, -9,
+    -25, -42, -60, -79, -98, -118, -138, -159,
+    -181, -203, -226, -249, -273, -296, -320, -344,
+    -368, -392, -416, -440, -463, -486, -508, -529,
+    -550, -570, -588, -606, -622, -636, -649, -660,
+    -670, -677, -682, -685, -685, -683, -678, -670,
+    -660, -646, -629, -608, -584, -557, -526, -491,
+    -452, -409, -363, -312, -258, -199, -137, -70,
+    0, 74, 153, 235, 320, 410, 502, 598,
+    697, 799, 903, 1010, 1119, 1229, 1342, 1455,
+    1569, 1683, 1798, 1911, 2024, 2136, 2245, 2353,
+    2457, 2557, 2654, 2745, 2832, 2912, 2986, 3052,
+    3110, 3160, 3201, 3232, 3252, 3261, 3258, 3242,
+    3213, 3170, 3113, 3041, 2953, 2849, 2728, 2591,
+    2435, 2262, 2071, 1861, 1632, 1385, 1118, 832,
+    527, 203, -139, -500, -880, -1277, -1691, -2122,
+    -2569, -3031, -3507, -3997, -4498, -5010, -5531, -6061,
+    -6597, -7137, -7680, -8225, -8768, -9308, -9843, -10370,
+    -10887, -11391, -11879, -12350, -12800, -13226, -13626, -13995,
+    -14332, -14634, -14896, -15116, -15291, -15417, -15492, -15511,
+    -15473, -15374, -15210, -14980, -14680, -14307, -13858, -13333,
+    -12727, -12038, -11266, -10408, -9462, -8428, -7304, -6090,
+    -4785, -3389, -1902, -326, 1339, 3092, 4931, 6853,
+    8856, 10937, 13092, 15317, 17608, 19959, 22364, 24819,
+    27315, 29846, 32405, 34982, 37570, 40158, 42738, 45298,
+    47828, 50317, 52753, 55123, 57415, 59616, 61712, 63691,
+    65536
+};
+
+// ELASTIC_IN shape with ELASTIC_OUT's period 0.3; ELASTIC_OUT(k) = 1 - f(1 - k)
+static const int32_t elastic_out_lut[RAMP_FIXED_LUT_SIZE + 1] = {
+    -32, -28, -24, -19, -14, -8, -2, 4,
+    10, 17, 24, 32, 39, 47, 54, 62,
+    70, 77, 85, 92, 99, 105, 111, 117,
+    122, 126, 129, 132, 134, 135, 135, 134,
+    132, 129, 124, 119, 112, 104, 95, 84,
+    72, 59, 45, 30, 14, -4, -22, -41,
+    -61, -81, -102, -124, -145, -167, -189, -210,
+    -231, -252, -271, -290, -308, -324, -338, -351,
+    -362, -371, -377, -381, -382, -380, -376, -368,
+    -357, -342, -324, -303, -278, -250, -218, -183,
+    -145, -103, -58, -10, 41, 94, 149, 206,
+    265, 326, 387, 448, 509, 570, 631, 689,
+    746, 800, 851, 898, 941, 979, 1012, 1040,
+    1060, 1074, 1080, 1079, 1069, 1050, 1023, 986,
+    939, 883, 817, 740, 655, 559, 453, 339,
+    215, 83, -57, -204, -359, -518, -683, -852,
+    -1024, -1198, -1372, -1545, -1716, -1883, -2046, -2202,
+    -2350, -2488, -2615, -2729, -2828, -2912, -2978, -3024,
+    -3051, -3055, -3037, -2994, -2927, -2833, -2712, -2564,
+    -2388, -2184, -1952, -1692, -1405, -1091, -752, -387,
+    0, 409, 838, 1284, 1745, 2218, 2701, 3190,
+    3682, 4174, 4661, 5139, 5605, 6054, 6482, 6884,
+    7256, 7594, 7892, 8147, 8353, 8508, 8606, 8644,
+    8619, 8526, 8363, 8127, 7816, 7428, 6962, 6417,
+    5793, 5089, 4308, 3450, 2519, 1516, 446, -687,
+    -1878, -3121, -4409, -5735, -7091, -8469, -9858, -11250,
+    -12634, -13998, -15331, -16622, -17857, -19025, -20113, -21109,
+    -21998, -22770, -23410, -23908, -24251, -24428, -24429, -24244,
+    -23863, -23279, -22485, -21476, -20246, -18794, -17117, -15217,
+    -13095, -10755, -8203, -5446, -2494, 641, 3946, 7404,
+    10998, 14709, 18514, 22389, 26309, 30247, 34173, 38057,
+    41867, 45570, 49131, 52516, 55688, 58612, 61252, 63572,
+    65536
+};
+
+/*-----------------------------
+ HELPERS
+ -----------------------------*/
+
+// Linear interpolation of a table at u in [0, 1], Q16.16.
+static inline int32_t lut(const int32_t *table, uint32_t u) {
+    if (u >= RAMP_FIXED_ONE) return table[RAMP_FIXED_LUT_SIZE];
+    uint32_t i = u >> 8;
+    int32_t f = u & 0xFF;
+    return table[i] + (((table[i + 1] - table[i]) * f) >> 8);
+}
+
+// Product of two Q16.16 values in [0, 1), rounded.
+static inline uint32_t qmul(uint32_t a, uint32_t b) {
+    return (a * b + 0x8000) >> 16;
+}
+
+// Signed product for the curves whose terms leave [0, 1].
+static inline int32_t smul(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b) >> 16);
+}
+
+// Integer square root; a Q32 fraction in gives a Q16.16 fraction out.
+static uint32_t isqrt(uint32_t x) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > x) bit >>= 2;
+    while (bit) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static int32_t fixed_powin(uint32_t k, uint8_t p) {
+    if (k >= RAMP_FIXED_ONE) return RAMP_FIXED_ONE;
+    uint32_t r = k;
+    while (--p) r = qmul(r, k);
+    return r;
+}
+
+static int32_t fixed_powout(uint32_t k, uint8_t p) {
+    return RAMP_FIXED_ONE - fixed_powin(RAMP_FIXED_ONE - k, p);
+}
+
+static int32_t fixed_powinout(uint32_t k, uint8_t p) {
+    k *= 2;
+    if (k < RAMP_FIXED_ONE)
+        return fixed_powin(k, p) / 2;
+    return RAMP_FIXED_ONE - fixed_powin(2 * RAMP_FIXED_ONE - k, p) / 2;
+}
+
+static int32_t bounce_out(uint32_t k) {
+    // Breakpoints 1, 2 and 2.5 over 2.75, rounded up so the integer tests match the
+    // float comparisons; the offsets are 1.5, 2.25 and 2.625 over 2.75.
+    int32_t x = k;
+    int32_t base = 0;
+    if (k >= 59579) {
+        x -= 62557;
+        base = 64512;               // 0.984375
+    } else if (k >= 47663) {
+        x -= 53620;
+        base = 61440;               // 0.9375
+    } else if (k >= 23832) {
+        x -= 35747;
+        base = 49152;               // 0.75
+    }
+    return ((smul(x, x) * 121) >> 4) + base;   // 7.5625 = 121 / 16
+}
+
+/*-----------------------------
+ EASING
+ -----------------------------*/
+
+int32_t ramp_fixed_calc(uint32_t k, ramp_mode m) {
+
+    if (k == 0)
+        return 0;
+    if (k >= RAMP_FIXED_ONE)
+        return RAMP_FIXED_ONE;
+
+    const int32_t one = RAMP_FIXED_ONE;
+    const int32_t back_s = 111515;          // 1.70158
+    const int32_t back_s2 = 170060;         // 1.70158 * 1.525
+    uint32_t r;
+    int32_t x;
+
+    switch (m) {
+        case QUADRATIC_IN:
+            return fixed_powin(k, 2);
+
+        case QUADRATIC_OUT:
+            return fixed_powout(k, 2);
+
+        case QUADRATIC_INOUT:
+            return fixed_powinout(k, 2);
+
+        case CUBIC_IN:
+            return fixed_powin(k, 3);
+
+        case CUBIC_OUT:
+            return fixed_powout(k, 3);
+
+        case CUBIC_INOUT:
+            return fixed_powinout(k, 3);
+
+        case QUARTIC_IN:
+            return fixed_powin(k, 4);
+
+        case QUARTIC_OUT:
+            return fixed_powout(k, 4);
+
+        case QUARTIC_INOUT:
+            return fixed_powinout(k, 4);
+
+        case QUINTIC_IN:
+            return fixed_powin(k, 5);
+
+        case QUINTIC_OUT:
+            return fixed_powout(k, 5);
+
+        case QUINTIC_INOUT:
+            return fixed_powinout(k, 5);
+
+        case SINUSOIDAL_IN:
+            return one - lut(sine_lut, one - k);
+
+        case SINUSOIDAL_OUT:
+            return lut(sine_lut, k);
+
+        case SINUSOIDAL_INOUT:
+            if (k < RAMP_FIXED_HALF)
+                return (one - lut(sine_lut, one - 2 * k)) / 2;
+            return RAMP_FIXED_HALF + lut(sine_lut, 2 * k - one) / 2;
+
+        case EXPONENTIAL_IN:
+            return lut(expo_lut, k);
+
+        case EXPONENTIAL_OUT:
+            return one - lut(expo_lut, one - k);
+
+        case EXPONENTIAL_INOUT:
+            if (k < RAMP_FIXED_HALF)
+                return lut(expo_lut, 2 * k) / 2;
+            return one - lut(expo_lut, 2 * (one - k)) / 2;
+
+        case CIRCULAR_IN:
+            return one - isqrt(0u - k * k);
+
+        case CIRCULAR_OUT:
+            r = one - k;
+            return isqrt(0u - r * r);
+
+        case CIRCULAR_INOUT:
+            k *= 2;
+            if (k < RAMP_FIXED_ONE)
+                return (one - isqrt(0u - k * k)) / 2;
+            r = 2 * one - k;
+            if (r >= RAMP_FIXED_ONE)
+                return RAMP_FIXED_HALF;
+            return (isqrt(0u - r * r) + one) / 2;
+
+        case ELASTIC_IN:
+            return lut(elastic_lut, k);
+
+        case ELASTIC_OUT:
+            return one - lut(elastic_out_lut, one - k);
+
+        case ELASTIC_INOUT:
+            if (k < RAMP_FIXED_HALF)
+                return lut(elastic_lut, 2 * k) / 2;
+            return one - lut(elastic_lut, 2 * (one - k)) / 2;
+
+        case BACK_IN:
+            x = k;
+            return smul(smul(x, x), smul(back_s + one, x) - back_s);
+
+        case BACK_OUT:
+            x = (int32_t)k - one;
+            return smul(smul(x, x), smul(back_s + one, x) + back_s) + one;
+
+        case BACK_INOUT:
+            x = 2 * k;
+            if (x < one)
+                return smul(smul(x, x), smul(back_s2 + one, x) - back_s2) / 2;
+            x -= 2 * one;
+            return smul(smul(x, x), smul(back_s2 + one, x) + back_s2) / 2 + one;
+
+        case BOUNCE_IN:
+            return one - bounce_out(one - k);
+
+        case BOUNCE_OUT:
+            return bounce_out(k);
+
+        case BOUNCE_INOUT:
+            if (k < RAMP_FIXED_HALF)
+                return (one - bounce_out(one - 2 * k)) / 2;
+            return bounce_out(2 * k - one) / 2 + RAMP_FIXED_HALF;
+
+        case LINEAR:
+        default:
+            return k;
+    }
+}
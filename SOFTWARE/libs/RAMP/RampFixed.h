@@ -0,0 +1,201 @@
+// Fixed-point ramps for the RAMP library
+//
+// Same go()/update() behaviour as _ramp<T> (10 ms grain, millis() time base,
+// every ramp_mode and loop_mode), but the position and the easing curve are
+// evaluated in Q16.16 integer arithmetic so an update costs no soft-float
+// calls on an FPU-less core. Polynomial, back, bounce and circular curves are
+// computed directly; sinusoidal, exponential and elastic curves interpolate
+// 257-entry tables. Values stay within one LSB of the float ramps.
+
+#ifndef RampFixed_h
+#define RampFixed_h
+
+#include <stdint.h>
+#include <limits>
+#include <type_traits>
+#include "Ramp.h"
+
+#define RAMP_FIXED_ONE 0x10000                      // 1.0 in Q16.16
+
+// Eased completion for a linear completion k, both Q16.16 (k in [0, 1]).
+// Back and elastic curves overshoot, so the result may leave [0, 1].
+int32_t ramp_fixed_calc(uint32_t k, ramp_mode mode);
+
+/*-----------------------------
+ POSITION AND TIMING
+ -----------------------------*/
+
+class rampFixedTimer {
+public:
+    uint32_t getDuration() const { return dur; }
+    uint32_t getPosition() const { return pos; }
+
+    bool isFinished() const { return speed == FORWARD ? pos == dur : pos == 0; }
+    bool isRunning() const { return !isFinished() && !paused; }
+    bool isPaused() const { return paused; }
+    void pause() { paused = true; }
+    void resume() { paused = false; }
+
+    void setAutomation(bool _automated) { automated = _automated; }
+    void setGrain(uint16_t _grain) { grain = _grain; }
+
+protected:
+    uint32_t pos = 0, dur = 0, t = 0;               // ramp position, duration and previous time
+    uint16_t grain = 10;                            // minimum interval between updates
+    ramp_mode mode = NONE;
+    loop_mode loop = ONCEFORWARD;
+    speed_mode speed = FORWARD;
+    bool automated = true;
+    bool paused = false;
+
+    void start(uint32_t _dur, ramp_mode _mode, loop_mode _loop) {
+        mode  = _mode;
+        dur   = _dur;
+        t     = millis();
+        loop  = _loop;
+        if (_loop < ONCEBACKWARD) {
+            pos   = 0;
+            speed = FORWARD;
+        } else {
+            pos   = dur;
+            speed = BACKWARD;
+        }
+        paused = false;
+    }
+
+    // Moves the position forward to `now`. Returns true when the value has
+    // to be recomputed, mirroring the conditions of _ramp<T>::update().
+    bool advance(uint32_t now) {
+        if (mode == NONE) return false;
+
+        uint32_t delta = grain;
+        if (automated) {
+            delta = now - t;
+            if (delta < grain) return false;
+        } else {
+            now = 0;
+        }
+        t = now;
+
+        if (isFinished()) {
+            switch (loop) {
+                case LOOPFORWARD:
+                    pos = 0;
+                    break;
+                case LOOPBACKWARD:
+                    pos = dur;
+                    break;
+                case FORTHANDBACK:
+                case BACKANDFORTH:
+                    speed = (speed == FORWARD) ? BACKWARD : FORWARD;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (paused) return false;
+
+        if (speed == FORWARD) {
+            pos = (dur - pos > delta) ? pos + delta : dur;
+        } else {
+            pos = (pos > delta) ? pos - delta : 0;
+        }
+        return true;
+    }
+
+    // Eased completion of the current position, Q16.16.
+    int32_t easing() const {
+        uint32_t k = (pos < RAMP_FIXED_ONE)
+            ? (pos << 16) / dur
+            : (uint32_t)(((uint64_t)pos << 16) / dur);
+        return ramp_fixed_calc(k, mode);
+    }
+};
+
+// a + (b - a) * e, floored like the float ramp's conversion back to T and
+// clamped to T, since overshooting curves can leave the type's range.
+template <class T>
+inline T ramp_fixed_lerp(T a, T b, int32_t e) {
+    int64_t v;
+    if (sizeof(T) == 1) {
+        v = (int32_t)a + (((int32_t)b - (int32_t)a) * e >> 16);
+    } else {
+        v = (int64_t)a + (((int64_t)b - (int64_t)a) * e >> 16);
+    }
+    if (v < (int64_t)std::numeric_limits<T>::min()) return std::numeric_limits<T>::min();
+    if (v > (int64_t)std::numeric_limits<T>::max()) return std::numeric_limits<T>::max();
+    return (T)v;
+}
+
+// a + (b - a) * pos / dur, floored. LINEAR ramps skip the Q16.16 completion
+// so wide ranges keep full precision.
+template <class T>
+inline T ramp_fixed_linear(T a, T b, uint32_t pos, uint32_t dur) {
+    if (sizeof(T) == 1 && pos < (1UL << 23)) {
+        int32_t n = ((int32_t)b - (int32_t)a) * (int32_t)pos;
+        int32_t d = dur;
+        return (T)(a + (n >= 0 ? n / d : -((d - 1 - n) / d)));
+    }
+    int64_t n = ((int64_t)b - (int64_t)a) * pos;
+    int64_t d = dur;
+    return (T)(a + (n >= 0 ? n / d : -((d - 1 - n) / d)));
+}
+
+/*-----------------------------
+ CLASS TEMPLATE
+ -----------------------------*/
+
+template <class T = uint8_t>
+class _rampFixed : public rampFixedTimer {
+    static_assert(std::is_integral<T>::value && sizeof(T) <= 4,
+                  "fixed-point ramps hold integers of up to 32 bits");
+
+public:
+    constexpr _rampFixed() : val(0), A(0), B(0) {}
+    constexpr _rampFixed(T _val) : val(_val), A(_val), B(_val) {}
+
+    T update() { return update(automated ? millis() : 0); }
+
+    // Update against a time already read, so several ramps advanced
+    // together share one millis() call.
+    T update(uint32_t now) {
+        if (advance(now)) {
+            if (dur == 0 || A == B)
+                val = B;
+            else if (mode == LINEAR)
+                val = ramp_fixed_linear(A, B, pos, dur);
+            else
+                val = ramp_fixed_lerp(A, B, easing());
+        }
+        return val;
+    }
+
+    T go(T _val) { return go(_val, 0, NONE); }
+    T go(T _val, uint32_t _dur) { return go(_val, _dur, LINEAR); }
+    T go(T _val, uint32_t _dur, ramp_mode _mode) { return go(_val, _dur, _mode, ONCEFORWARD); }
+    T go(T _val, uint32_t _dur, ramp_mode _mode, loop_mode _loop) {
+        A = val;
+        B = _val;
+        start(_dur, _mode, _loop);
+        if (_dur == 0) val = B;
+        return val;
+    }
+
+    T getValue() const { return val; }
+    T getOrigin() const { return A; }
+    T getTarget() const { return B; }
+
+private:
+    T val, A, B;                                    // actual, origin and destination values
+};
+
+/*-----------------------------
+ CLASS ALIAS
+ -----------------------------*/
+
+typedef _rampFixed<uint8_t> rampFixedByte;
+typedef _rampFixed<uint16_t> rampFixedUInt16;
+typedef _rampFixed<uint32_t> rampFixedUInt32;
+
+#endif /* RampFixed_h */
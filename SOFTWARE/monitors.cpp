@@ -19,6 +19,7 @@
 #include "future_sequences.h"
 #include "heat.h"
 #include "klystron_IO_support.h"
+#include "led_core.h"
 #include "led_patterns.h"
 #include "monster.h"
 #include "pack_config.h"
@@ -27,6 +28,7 @@
 #include "pico/stdlib.h"
 #include "powercell_sequences.h"
 #include "sound_module.h"
+#include "task_scheduler.h"
 #include <stdlib.h>
 
 /** Maximum time to wait for mode change effects (ms). */
@@ -134,42 +136,58 @@ void song_monitor(void) {
 }
 
 /**
- * @brief Start a sound and ensure playback begins, clearing any active song.
+ * @brief Start a sound in place of whatever is playing, clearing any active
+ * song.
+ *
+ * Returns once the play command is queued. The stop is coalesced with the
+ * start into a single play frame, and `sound_is_playing()` reports the new
+ * sound as playing until BUSY confirms it or the start wait runs out.
  *
  * @param sound_index Index of the sound to start.
  */
 void sound_start_safely(uint8_t sound_index) {
   song &= 0x7F; // Clear the song playing flag
-  // Ensure any LED DMA transfers have completed to avoid contention when
-  // communicating with the sound module.
-  if (sound_is_playing()) {
-    sound_stop();
-    absolute_time_t start = get_absolute_time();
-    while (sound_is_playing()) {
-      if (absolute_time_diff_us(start, get_absolute_time()) >
-          MODE_CHANGE_TIMEOUT_MS * 1000) {
-        break;
-      }
-      tight_loop_contents();
-    }
-  }
+  sound_stop();
   sound_start(sound_index);
-  absolute_time_t start = get_absolute_time();
-  while (!sound_is_playing()) {
-    if (absolute_time_diff_us(start, get_absolute_time()) >
-        MODE_CHANGE_TIMEOUT_MS * 1000) {
-      break;
-    }
-    tight_loop_contents();
+}
+
+/** @brief Cleared by `sound_play_blocking()` and set when its sound ends. */
+static volatile bool blocking_done = true;
+
+/**
+ * @brief Notification for `sound_play_blocking()`: flags the sound's end.
+ */
+static void blocking_notify(sound_event_t event, void *context) {
+  if (event == SOUND_EVENT_FINISHED) {
+    *(volatile bool *)context = true;
   }
 }
 
 /**
  * @brief Start a sound and wait until completion.
+ *
+ * Plays through `sound_play_notify()` and waits for its finished event, so a
+ * sound that never raises BUSY ends the wait after the start timeout and a
+ * stop or replacement from the pack timer ends it straight away. The flag is
+ * static because an aborted wait leaves the notification registered until
+ * the sound ends.
+ *
+ * @param sound_index Index of the sound to play.
+ * @param fire If true, return early when the activation switch is pressed.
+ * @param shutdown If true, return early when a pack shutdown is requested.
  */
 void sound_play_blocking(uint8_t sound_index, bool fire, bool shutdown) {
-  sound_start_safely(sound_index);
-  sound_wait_til_end(fire, shutdown);
+  song &= 0x7F; // Clear the song playing flag
+  sound_stop();
+  blocking_done = false;
+  sound_play_notify(sound_index, blocking_notify, (void *)&blocking_done);
+  while (!blocking_done) {
+    sleep_ms(10);
+    if (fire && fire_sw())
+      break;
+    if (shutdown && !pu_sw() && !pack_pu_sw() && !wand_standby_sw())
+      break;
+  }
 }
 
 /**
@@ -289,15 +307,16 @@ static void update_animation_speed(AnimationController &controller,
   if (speed == last_speed) {
     return;
   }
-  Animation *anim = controller.getCurrentAnimation();
-  if (anim) {
-    anim->setSpeed(speed, 0);
-  }
+  controller.setSpeed(speed);
   last_speed = speed;
 }
 
 /**
  * @brief Update LED pattern speeds based on ADJ settings and pack heat.
+ * @details Only the powercell follows ADJ0 and heat here. The cyclotron
+ *          is held at a fixed speed, or on Afterlife packs sped up and
+ *          slowed down through its controller's time scale, by
+ *          `cy_speed_apply`.
  */
 void adj_monitor(void) {
   bool heating_effect =
@@ -305,102 +324,122 @@ void adj_monitor(void) {
   read_adj_potentiometers(true);     // read the ADC and average the samples
 
   static uint16_t last_pc_speed = 0;
-  static uint16_t last_cy_speed = 0;
 
   uint16_t pc_speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, heating_effect, false);
   update_animation_speed(g_powercell_controller, pc_speed, last_pc_speed);
-
-  uint16_t cy_speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, heating_effect, true);
-  update_animation_speed(g_cyclotron_controller, cy_speed, last_cy_speed);
 }
 
+/** Major mode changes and vents run as tasks so the main loop keeps going. */
+static pack_task_t mode_change_task;
+static pack_task_t vent_task;
+
+/** Steps of the major mode change task. */
+enum {
+  MODE_CHANGE_DRAIN,   /**< Powercell drain, cyclotron fade-out and first sound. */
+  MODE_CHANGE_SOUND,   /**< The rest of the first sound. */
+  MODE_CHANGE_FADE_IN, /**< Cyclotron fade-in with the second sound. */
+};
+
+/** What the running mode change was started with. */
+static struct {
+  bool afterlife_variant;
+  uint8_t second_sound;
+} mode_change;
+
+/** Steps of the vent task. */
+enum {
+  VENT_LIGHT_ON,  /**< Vent light lit for 50 ms. */
+  VENT_LIGHT_OFF, /**< Vent light dark for 120 ms. */
+};
+
+/** Remembered while venting for restoring the idle animations. */
+static bool vent_afterlife;
+
 /**
- * @brief Perform a major mode change with coordinated sounds and lights.
- *
- * @param cyclotron_pattern_base Base cyclotron pattern index.
- * @param first_sound Sound to play during drain.
- * @param second_sound Optional sound to play with fade-in.
+ * @brief True when a mode change should stop waiting: the user fires or
+ *        powers the wand off.
  */
-void mode_change_major(uint8_t cyclotron_pattern_base, uint8_t first_sound,
-                       uint8_t second_sound) {
-  const bool afterlife_std = (config_pack_type() == PACK_TYPE_AFTERLIFE);
-  const bool afterlife_tvg = (config_pack_type() == PACK_TYPE_AFTER_TVG);
-  const bool afterlife_variant = afterlife_std || afterlife_tvg;
+static bool mode_change_interrupted(void) { return fire_sw() || !pu_sw(); }
 
-  sound_start_safely(first_sound);
-
-  AnimationConfig pc_drain_config;
-  pc_drain_config.leds = g_powercell_leds;
-  pc_drain_config.num_leds = NUM_LEDS_POWERCELL;
-  pc_drain_config.color =
-      CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
-  pc_drain_config.speed = 300;
-  g_powercell_controller.play(std::make_unique<DrainAnimation>(),
-                              pc_drain_config);
+/**
+ * @brief True once the current mode change stage has run too long or the
+ *        user has interrupted it.
+ */
+static bool mode_change_waited_out(const pack_task_t *task) {
+  return task_elapsed_ms(task) > MODE_CHANGE_TIMEOUT_MS ||
+         mode_change_interrupted();
+}
 
-  if (!afterlife_variant) {
-    AnimationConfig cy_fade_out_config;
-    cy_fade_out_config.leds = g_cyclotron_leds;
-    cy_fade_out_config.num_leds = g_cyclotron_led_count;
-    cy_fade_out_config.color =
-        CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
-    cy_fade_out_config.speed = 300;
-    g_cyclotron_controller.play(std::make_unique<FadeAnimation>(true),
-                                cy_fade_out_config);
+/**
+ * @brief Cools the pack and restores the cyclotron color after a mode change.
+ */
+static void mode_change_settle(void) {
+  cool_the_pack();
+  if (config_pack_type() == PACK_TYPE_AFTER_TVG) {
+    g_cyclotron_controller.enqueue<ChangeColorAction>(
+        CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b), 1000);
   }
+}
 
-  absolute_time_t start = get_absolute_time();
-  while (g_powercell_controller.isRunning() ||
+/**
+ * @brief Major mode change task: waits out each stage of the drain, sound
+ *        and fade-in, then restores the idle cyclotron pattern.
+ * @details Each wait gives up after `MODE_CHANGE_TIMEOUT_MS`, or at once
+ *          when `mode_change_interrupted()`.
+ */
+static void mode_change_step(pack_task_t *task) {
+  const bool afterlife_variant = mode_change.afterlife_variant;
+
+  switch (task->step) {
+  case MODE_CHANGE_DRAIN: {
+    if (!mode_change_waited_out(task) &&
+        (g_powercell_controller.isRunning() ||
          (!afterlife_variant && g_cyclotron_controller.isRunning()) ||
-         sound_is_playing()) {
-    if (absolute_time_diff_us(start, get_absolute_time()) >
-        MODE_CHANGE_TIMEOUT_MS * 1000) {
-      break;
+         sound_is_playing())) {
+      return;
     }
-    sleep_ms(20);
-  }
 
-  update_pack_colors();
+    update_pack_colors();
 
-  AnimationConfig pc_normal_config;
-  pc_normal_config.leds = g_powercell_leds;
-  pc_normal_config.num_leds = NUM_LEDS_POWERCELL;
-  pc_normal_config.color =
-      CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
-  pc_normal_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
-  g_powercell_controller.play(std::make_unique<ScrollAnimation>(),
-                              pc_normal_config);
+    AnimationConfig pc_normal_config;
+    pc_normal_config.leds = g_powercell_leds;
+    pc_normal_config.num_leds = NUM_LEDS_POWERCELL;
+    pc_normal_config.color =
+        CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
+    pc_normal_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
+    g_powercell_controller.play<ScrollAnimation>(pc_normal_config);
 
-  start = get_absolute_time();
-  while (sound_is_playing()) {
-    if (absolute_time_diff_us(start, get_absolute_time()) >
-        MODE_CHANGE_TIMEOUT_MS * 1000) {
-      break;
-    }
-    sleep_ms(20);
+    task_mark(task);
+    task->step = MODE_CHANGE_SOUND;
   }
-
-  if (second_sound != 0) {
-    sound_start_safely(second_sound);
-    if (!afterlife_variant) {
-      AnimationConfig cy_fade_in_config;
-      cy_fade_in_config.leds = g_cyclotron_leds;
-      cy_fade_in_config.num_leds = g_cyclotron_led_count;
-      cy_fade_in_config.color =
-          CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
-      cy_fade_in_config.speed = 1000;
-      g_cyclotron_controller.play(std::make_unique<FadeAnimation>(false),
-                                  cy_fade_in_config);
-
-      start = get_absolute_time();
-      while (g_cyclotron_controller.isRunning() || sound_is_playing()) {
-        if (absolute_time_diff_us(start, get_absolute_time()) >
-            MODE_CHANGE_TIMEOUT_MS * 1000) {
-          break;
-        }
-        sleep_ms(20);
+    // fall through
+  case MODE_CHANGE_SOUND:
+    if (!mode_change_waited_out(task) && sound_is_playing()) {
+      return;
+    }
+    if (mode_change.second_sound != 0 && !mode_change_interrupted()) {
+      sound_start_safely(mode_change.second_sound);
+      if (!afterlife_variant) {
+        AnimationConfig cy_fade_in_config;
+        cy_fade_in_config.leds = g_cyclotron_leds;
+        cy_fade_in_config.num_leds = g_cyclotron_led_count;
+        cy_fade_in_config.color =
+            CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
+        cy_fade_in_config.speed = 1000;
+        g_cyclotron_controller.play<FadeAnimation>(cy_fade_in_config, false);
+
+        task_mark(task);
+        task->step = MODE_CHANGE_FADE_IN;
+        return;
       }
     }
+    break;
+  case MODE_CHANGE_FADE_IN:
+    if (!mode_change_waited_out(task) &&
+        (g_cyclotron_controller.isRunning() || sound_is_playing())) {
+      return;
+    }
+    break;
   }
 
   if (!afterlife_variant) {
@@ -417,17 +456,60 @@ void mode_change_major(uint8_t cyclotron_pattern_base, uint8_t first_sound,
       cy_base_config.steps = 64;
       if (pack_state_get_mode() == PACK_MODE_SLIME_BLOWER ||
           pack_state_get_mode() == PACK_MODE_SLIME_TETHER) {
-        g_cyclotron_controller.play(std::make_unique<SlimeAnimation>(),
-                                    cy_base_config);
+        g_cyclotron_controller.play<SlimeAnimation>(cy_base_config);
       } else {
-        g_cyclotron_controller.play(std::make_unique<RotateFadeAnimation>(),
-                                    cy_base_config);
+        g_cyclotron_controller.play<RotateFadeAnimation>(cy_base_config);
       }
     } else {
-      g_cyclotron_controller.play(std::make_unique<RotateAnimation>(),
-                                  cy_base_config);
+      g_cyclotron_controller.play<RotateAnimation>(cy_base_config);
     }
   }
+
+  mode_change_settle();
+  // Taps made during the change do not queue another one.
+  clear_fire_tap();
+  task_finish(task);
+}
+
+/**
+ * @brief Start a major mode change with coordinated sounds and lights.
+ * @details Starts the first sound, the powercell drain and the cyclotron
+ *          fade-out; the rest of the change runs as a task from
+ *          `task_service()`.
+ *
+ * @param cyclotron_pattern_base Base cyclotron pattern index.
+ * @param first_sound Sound to play during drain.
+ * @param second_sound Optional sound to play with fade-in.
+ */
+void mode_change_major(uint8_t cyclotron_pattern_base, uint8_t first_sound,
+                       uint8_t second_sound) {
+  const bool afterlife_std = (config_pack_type() == PACK_TYPE_AFTERLIFE);
+  const bool afterlife_tvg = (config_pack_type() == PACK_TYPE_AFTER_TVG);
+  const bool afterlife_variant = afterlife_std || afterlife_tvg;
+
+  sound_start_safely(first_sound);
+
+  AnimationConfig pc_drain_config;
+  pc_drain_config.leds = g_powercell_leds;
+  pc_drain_config.num_leds = NUM_LEDS_POWERCELL;
+  pc_drain_config.color =
+      CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
+  pc_drain_config.speed = 300;
+  g_powercell_controller.play<DrainAnimation>(pc_drain_config);
+
+  if (!afterlife_variant) {
+    AnimationConfig cy_fade_out_config;
+    cy_fade_out_config.leds = g_cyclotron_leds;
+    cy_fade_out_config.num_leds = g_cyclotron_led_count;
+    cy_fade_out_config.color =
+        CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
+    cy_fade_out_config.speed = 300;
+    g_cyclotron_controller.play<FadeAnimation>(cy_fade_out_config, true);
+  }
+
+  mode_change.afterlife_variant = afterlife_variant;
+  mode_change.second_sound = second_sound;
+  task_start(&mode_change_task, mode_change_step, MODE_CHANGE_DRAIN);
 }
 
 /**
@@ -480,68 +562,39 @@ void mode_monitor(void) {
       mode_change_major(5, 43, 0);
       break;
     }
-    cool_the_pack();
-    if (config_pack_type() == PACK_TYPE_AFTER_TVG) {
-      g_cyclotron_controller.enqueue(std::make_unique<ChangeColorAction>(
-          CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b), 1000));
+    // A major change settles the pack itself once it has finished.
+    if (!task_is_running(&mode_change_task)) {
+      mode_change_settle();
     }
   }
   clear_fire_tap();
 }
 
 /**
- * @brief Run a full vent sequence with sound and lighting effects.
+ * @brief Vent task: blinks the vent light, then puts the idle animations
+ *        back once the vent is over.
+ * @details Powering the wand off ends the vent at the next step.
  */
-void full_vent(void) {
-  cool_the_pack();
-  sound_start_safely(55);
-  const PackType pack_type = config_pack_type();
-  const bool is_afterlife_pack =
-      (pack_type == PACK_TYPE_AFTERLIFE) || (pack_type == PACK_TYPE_AFTER_TVG);
-  AnimationConfig fr_config;
-  fr_config.leds = g_future_leds;
-  fr_config.num_leds = NUM_LEDS_FUTURE;
-  fr_config.color = CRGB(future_color.r, future_color.g, future_color.b);
-
-  if (is_afterlife_pack) {
-    fr_config.speed = 600;
-    fr_config.clockwise = false;
-    g_future_controller.play(std::make_unique<ShiftRotateAnimation>(),
-                             fr_config);
-  } else {
-    fr_config.speed = 150;
-    g_future_controller.play(std::make_unique<StrobeAnimation>(), fr_config);
-  }
-
-  AnimationConfig pc_drain_config;
-  pc_drain_config.leds = g_powercell_leds;
-  pc_drain_config.num_leds = NUM_LEDS_POWERCELL;
-  pc_drain_config.color =
-      CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
-  pc_drain_config.speed = 3600;
-  g_powercell_controller.play(std::make_unique<DrainAnimation>(),
-                              pc_drain_config);
-
-  if (!is_afterlife_pack) {
-    AnimationConfig cy_config;
-    cy_config.leds = g_cyclotron_leds;
-    cy_config.num_leds = g_cyclotron_led_count;
-    cy_config.color =
-        CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
-    cy_config.speed = 3600;
-    g_cyclotron_controller.play(std::make_unique<FadeAnimation>(true),
-                                cy_config);
-  }
-  do {
-    vent_light_on(true);
-    sleep_ms(50);
+static void vent_step(pack_task_t *task) {
+  const bool is_afterlife_pack = vent_afterlife;
+
+  switch (task->step) {
+  case VENT_LIGHT_ON:
+    if ((vent_sw() || sound_is_playing()) && pu_sw()) {
+      vent_light_on(true);
+      task_sleep_ms(task, 50, VENT_LIGHT_OFF);
+      return;
+    }
+    break;
+  case VENT_LIGHT_OFF:
     vent_light_on(false);
-    sleep_ms(120);
-  } while (vent_sw() || sound_is_playing());
+    task_sleep_ms(task, 120, VENT_LIGHT_ON);
+    return;
+  }
 
   // Stop all animations that were started for the vent sequence.
   g_future_controller.stop();
-  fill_solid(g_future_leds, NUM_LEDS_FUTURE, CRGB::Black);
+  led_core_call([]() { fill_solid(g_future_leds, NUM_LEDS_FUTURE, CRGB::Black); });
   show_leds();
   g_powercell_controller.stop();
   if (!is_afterlife_pack) {
@@ -555,8 +608,7 @@ void full_vent(void) {
   pc_normal_config.color =
       CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
   pc_normal_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
-  g_powercell_controller.play(std::make_unique<ScrollAnimation>(),
-                              pc_normal_config);
+  g_powercell_controller.play<ScrollAnimation>(pc_normal_config);
 
   if (is_afterlife_pack) {
     AnimationConfig cy_config;
@@ -565,7 +617,8 @@ void full_vent(void) {
         CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
     cy_config.leds = g_cyclotron_leds;
     cy_config.num_leds = g_cyclotron_led_count;
-    g_cyclotron_controller.play(std::make_unique<CylonAnimation>(), cy_config);
+    cy_config.motion_blur = true;
+    g_cyclotron_controller.play<CylonAnimation>(cy_config);
   } else {
     AnimationConfig cy_config;
     cy_config.leds = g_cyclotron_leds;
@@ -574,10 +627,64 @@ void full_vent(void) {
         CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
     cy_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, true);
     cy_config.clockwise = (config_cyclotron_dir() == 0);
-    g_cyclotron_controller.play(std::make_unique<RotateAnimation>(), cy_config);
+    g_cyclotron_controller.play<RotateAnimation>(cy_config);
+  }
+
+  task_finish(task);
+}
+
+/**
+ * @brief Start a full vent sequence with sound and lighting effects.
+ * @details Starts the vent sound and animations; blinking the vent light
+ *          until the vent switch is released and the sound ends, then
+ *          restoring the idle animations, runs as a task from
+ *          `task_service()`.
+ */
+void full_vent(void) {
+  cool_the_pack();
+  sound_start_safely(55);
+  const PackType pack_type = config_pack_type();
+  const bool is_afterlife_pack =
+      (pack_type == PACK_TYPE_AFTERLIFE) || (pack_type == PACK_TYPE_AFTER_TVG);
+  AnimationConfig fr_config;
+  fr_config.leds = g_future_leds;
+  fr_config.num_leds = NUM_LEDS_FUTURE;
+  fr_config.color = CRGB(future_color.r, future_color.g, future_color.b);
+
+  if (is_afterlife_pack) {
+    fr_config.speed = 600;
+    fr_config.clockwise = false;
+    g_future_controller.play<ShiftRotateAnimation>(fr_config);
+  } else {
+    fr_config.speed = 150;
+    g_future_controller.play<StrobeAnimation>(fr_config);
   }
+
+  AnimationConfig pc_drain_config;
+  pc_drain_config.leds = g_powercell_leds;
+  pc_drain_config.num_leds = NUM_LEDS_POWERCELL;
+  pc_drain_config.color =
+      CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
+  pc_drain_config.speed = 3600;
+  g_powercell_controller.play<DrainAnimation>(pc_drain_config);
+
+  if (!is_afterlife_pack) {
+    AnimationConfig cy_config;
+    cy_config.leds = g_cyclotron_leds;
+    cy_config.num_leds = g_cyclotron_led_count;
+    cy_config.color =
+        CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
+    cy_config.speed = 3600;
+    g_cyclotron_controller.play<FadeAnimation>(cy_config, true);
+  }
+  vent_afterlife = is_afterlife_pack;
+  vent_light_on(true);
+  task_start(&vent_task, vent_step, VENT_LIGHT_ON);
+  task_sleep_ms(&vent_task, 50, VENT_LIGHT_OFF);
 }
 
+bool full_vent_is_running(void) { return task_is_running(&vent_task); }
+
 /**
  * @brief Monitor the vent switch and trigger vent sequences or quotes.
  */
@@ -31,7 +31,7 @@ bool song_is_playing(void);
 /** @brief Monitors the song switch for changes and handles song/party mode logic. */
 void song_monitor(void);
 
-/** @brief Starts a sound safely, ensuring any currently playing sound is stopped first. */
+/** @brief Starts a sound in place of any currently playing sound, without waiting. */
 void sound_start_safely(uint8_t sound_index);
 
 /**
@@ -70,9 +70,16 @@ void vent_monitor(void);
 /** @brief Monitors the ADJ1 potentiometer to update the cyclotron's active LED count (`N`). */
 void ring_monitor(void);
 
-/** @brief Triggers a full vent sequence with coordinated lights and sound. */
+/**
+ * @brief Triggers a full vent sequence with coordinated lights and sound.
+ * @details Returns once the vent has started; the rest runs from
+ *          `task_service()`.
+ */
 void full_vent(void);
 
+/** @brief True until a vent started by `full_vent` has finished. */
+bool full_vent_is_running(void);
+
 #ifdef __cplusplus
 }
 #endif
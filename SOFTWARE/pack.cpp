@@ -23,29 +23,127 @@
 #include "pack_config.h"
 #include "animations.h"
 #include "action.h"
-#include <memory>
+#include "led_core.h"
+#include "task_scheduler.h"
 
 /** Target speed ramp parameters for the Afterlife spin-up. */
 static const uint32_t AFTERLIFE_RAMP_DURATION_MS = 6000;
 static const uint32_t AFTERLIFE_RAMP_START_SPEED_X = 5;
 
+/** Start-up and power-down run as tasks so the main loop keeps going. */
+static pack_task_t startup_task;
+static pack_task_t powerdown_task;
+
+/** Steps of the start-up task; each names what it waits for. */
+enum {
+    STARTUP_SOUND_END,      /**< Snap: the power-up sound to end. */
+    STARTUP_FADE_IN,        /**< Fade/TVG: the fade-in animations and sound. */
+    STARTUP_SPIN_UP,        /**< Afterlife: the powercell waterfall. */
+    STARTUP_SPIN_SOUND,     /**< Afterlife: the rest of the power-up sound. */
+};
+
+/** Steps of the power-down task. */
+enum {
+    POWERDOWN_WAIT,         /**< The power-down animations and sound. */
+    POWERDOWN_SETTLE,       /**< A short pause before the final reset. */
+};
+
+/**
+ * @brief True when the user cuts the start-up short by firing or powering off.
+ */
+static bool startup_interrupted(void) {
+    return (!pu_sw() && !pack_pu_sw() && !wand_standby_sw()) || fire_sw();
+}
+
+/**
+ * @brief Switches the powercell and cyclotron to their idle patterns after
+ *        a Fade or TVG start-up.
+ */
+static void startup_fade_in_done(void) {
+    AnimationConfig pc_config;
+    pc_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
+    pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
+    pc_config.leds = g_powercell_leds;
+    pc_config.num_leds = NUM_LEDS_POWERCELL;
+    g_powercell_controller.play<ScrollAnimation>(pc_config);
+
+    AnimationConfig cy_config;
+    cy_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, true);
+    cy_config.color = CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
+    cy_config.clockwise = (config_cyclotron_dir() == 0);
+    cy_config.leds = g_cyclotron_leds;
+    cy_config.num_leds = g_cyclotron_led_count;
+    cy_config.fade_amount = 4;
+    cy_config.steps = 64;
+    if (config_pack_type() == PACK_TYPE_TVG_FADE &&
+        (pack_state_get_mode() == PACK_MODE_SLIME_BLOWER ||
+         pack_state_get_mode() == PACK_MODE_SLIME_TETHER)) {
+        g_cyclotron_controller.play<SlimeAnimation>(cy_config);
+    } else {
+        g_cyclotron_controller.play<RotateFadeAnimation>(cy_config);
+    }
+}
+
 /**
- * @brief Executes the main power-up sequence for the currently active pack type.
+ * @brief Start-up task: waits out the power-up sound and animations, then
+ *        settles into the idle patterns.
+ * @details Every wait ends early when `startup_interrupted()`, so a fire or
+ *          power-off request reaches the state machine on the same pass.
+ */
+static void startup_step(pack_task_t *task) {
+    switch (task->step) {
+    case STARTUP_SOUND_END:
+        // A queued sound counts as playing until BUSY rises or times out.
+        if (sound_is_playing() && !startup_interrupted()) {
+            return;
+        }
+        break;
+    case STARTUP_FADE_IN:
+        if (!startup_interrupted() &&
+            (g_powercell_controller.isRunning() || g_cyclotron_controller.isRunning() ||
+             sound_is_playing())) {
+            return;
+        }
+        startup_fade_in_done();
+        break;
+    case STARTUP_SPIN_UP:
+        if (!startup_interrupted() &&
+            (g_powercell_controller.isRunning() ||
+             ((config_pack_type() != PACK_TYPE_AFTERLIFE) &&
+              (config_pack_type() != PACK_TYPE_AFTER_TVG) &&
+              g_cyclotron_controller.isRunning()))) {
+            return;
+        }
+        {
+            AnimationConfig pc_config;
+            pc_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
+            pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
+            pc_config.leds = g_powercell_leds;
+            pc_config.num_leds = NUM_LEDS_POWERCELL;
+            g_powercell_controller.play<ScrollAnimation>(pc_config);
+        }
+        task->step = STARTUP_SPIN_SOUND;
+        // fall through
+    case STARTUP_SPIN_SOUND:
+        if (sound_is_playing() && !startup_interrupted()) {
+            return;
+        }
+        break;
+    }
+    // Taps made while starting up are not mode changes.
+    clear_fire_tap();
+    task_finish(task);
+}
+
+/**
+ * @brief Starts the main power-up sequence for the currently active pack type.
  * @details This function coordinates the sound and light animations for a full
  *          pack startup. The specific sounds and light patterns are determined
  *          by the pack type selected via DIP switches. It handles different
  *          startup logic for each pack variant (Classic, Fade, TVG, Afterlife).
+ *          The sound and first animations start here; the rest of the
+ *          sequence runs as a task from `task_service()`.
  */
-static void wait_for_animations_or_user() {
-    do {
-        sleep_ms(20);
-        if (!pu_sw() && !pack_pu_sw() && !wand_standby_sw())
-            break;
-        if (fire_sw())
-            break;
-    } while (g_powercell_controller.isRunning() || g_cyclotron_controller.isRunning() || sound_is_playing());
-}
-
 void pack_combo_startup(void) {
     // Ensure colors are refreshed in case a previous shutdown left the
     // palettes altered.
@@ -75,7 +173,7 @@ void pack_combo_startup(void) {
             pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
             pc_config.leds = g_powercell_leds;
             pc_config.num_leds = NUM_LEDS_POWERCELL;
-            g_powercell_controller.play(std::make_unique<ScrollAnimation>(), pc_config);
+            g_powercell_controller.play<ScrollAnimation>(pc_config);
 
             AnimationConfig cy_config;
             cy_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, true);
@@ -83,9 +181,9 @@ void pack_combo_startup(void) {
             cy_config.clockwise = (config_cyclotron_dir() == 0);
             cy_config.leds = g_cyclotron_leds;
             cy_config.num_leds = g_cyclotron_led_count;
-            g_cyclotron_controller.play(std::make_unique<RotateAnimation>(), cy_config);
+            g_cyclotron_controller.play<RotateAnimation>(cy_config);
         }
-        sound_wait_til_end(true, true);
+        task_start(&startup_task, startup_step, STARTUP_SOUND_END);
         break;
     case PACK_TYPE_FADE_RED:
         sound_start_safely(10);
@@ -95,34 +193,16 @@ void pack_combo_startup(void) {
             pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
             pc_config.leds = g_powercell_leds;
             pc_config.num_leds = NUM_LEDS_POWERCELL;
-            g_powercell_controller.play(std::make_unique<WaterfallAnimation>(), pc_config);
+            g_powercell_controller.play<WaterfallAnimation>(pc_config);
 
             AnimationConfig cy_config;
             cy_config.speed = 4800;
             cy_config.color = CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
             cy_config.leds = g_cyclotron_leds;
             cy_config.num_leds = g_cyclotron_led_count;
-            g_cyclotron_controller.play(std::make_unique<FadeAnimation>(false), cy_config);
-        }
-        wait_for_animations_or_user();
-        {
-            AnimationConfig pc_config;
-            pc_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
-            pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
-            pc_config.leds = g_powercell_leds;
-            pc_config.num_leds = NUM_LEDS_POWERCELL;
-            g_powercell_controller.play(std::make_unique<ScrollAnimation>(), pc_config);
-
-            AnimationConfig cy_config;
-            cy_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, true);
-            cy_config.color = CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
-            cy_config.clockwise = (config_cyclotron_dir() == 0);
-            cy_config.leds = g_cyclotron_leds;
-            cy_config.num_leds = g_cyclotron_led_count;
-            cy_config.fade_amount = 4;
-            cy_config.steps = 64;
-            g_cyclotron_controller.play(std::make_unique<RotateFadeAnimation>(), cy_config);
+            g_cyclotron_controller.play<FadeAnimation>(cy_config, false);
         }
+        task_start(&startup_task, startup_step, STARTUP_FADE_IN);
         break;
     case PACK_TYPE_TVG_FADE:
         sound_start_safely(58);
@@ -132,39 +212,16 @@ void pack_combo_startup(void) {
             pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
             pc_config.leds = g_powercell_leds;
             pc_config.num_leds = NUM_LEDS_POWERCELL;
-            g_powercell_controller.play(std::make_unique<WaterfallAnimation>(), pc_config);
+            g_powercell_controller.play<WaterfallAnimation>(pc_config);
 
             AnimationConfig cy_config;
             cy_config.speed = 4800;
             cy_config.color = CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
             cy_config.leds = g_cyclotron_leds;
             cy_config.num_leds = g_cyclotron_led_count;
-            g_cyclotron_controller.play(std::make_unique<FadeAnimation>(false), cy_config);
-        }
-        wait_for_animations_or_user();
-        {
-            AnimationConfig pc_config;
-            pc_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
-            pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
-            pc_config.leds = g_powercell_leds;
-            pc_config.num_leds = NUM_LEDS_POWERCELL;
-            g_powercell_controller.play(std::make_unique<ScrollAnimation>(), pc_config);
-
-            AnimationConfig cy_config;
-            cy_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, true);
-            cy_config.color = CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
-            cy_config.clockwise = (config_cyclotron_dir() == 0);
-            cy_config.leds = g_cyclotron_leds;
-            cy_config.num_leds = g_cyclotron_led_count;
-            cy_config.fade_amount = 4;
-            cy_config.steps = 64;
-            if (pack_state_get_mode() == PACK_MODE_SLIME_BLOWER ||
-                pack_state_get_mode() == PACK_MODE_SLIME_TETHER) {
-                g_cyclotron_controller.play(std::make_unique<SlimeAnimation>(), cy_config);
-            } else {
-                g_cyclotron_controller.play(std::make_unique<RotateFadeAnimation>(), cy_config);
-            }
+            g_cyclotron_controller.play<FadeAnimation>(cy_config, false);
         }
+        task_start(&startup_task, startup_step, STARTUP_FADE_IN);
         break;
     default: // Afterlife
         sound_start_safely(121);
@@ -174,57 +231,19 @@ void pack_combo_startup(void) {
             pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
             pc_config.leds = g_powercell_leds;
             pc_config.num_leds = NUM_LEDS_POWERCELL;
-            g_powercell_controller.play(std::make_unique<WaterfallAnimation>(), pc_config);
+            g_powercell_controller.play<WaterfallAnimation>(pc_config);
 
             AnimationConfig cy_config;
             cy_config.speed = 1000;
             cy_config.color = CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
             cy_config.leds = g_cyclotron_leds;
             cy_config.num_leds = g_cyclotron_led_count;
-            g_cyclotron_controller.play(std::make_unique<CylonAnimation>(), cy_config);
+            // The spin-up passes several LEDs per tick at full speed
+            cy_config.motion_blur = true;
+            g_cyclotron_controller.play<CylonAnimation>(cy_config);
         }
 
-        do {
-            cy_speed_ramp_update();
-            if (auto* anim = g_cyclotron_controller.getCurrentAnimation()) {
-                uint32_t speed = 1000;
-                if (cy_speed_multiplier > 0) {
-                    speed = speed * (1 << 16) / cy_speed_multiplier;
-                }
-                anim->setSpeed(speed, 0);
-            }
-            show_leds();
-            sleep_ms(20);
-            if (!pu_sw() && !pack_pu_sw() && !wand_standby_sw()) break;
-            if (fire_sw()) break;
-        } while (g_powercell_controller.isRunning() ||
-                 ((config_pack_type() != PACK_TYPE_AFTERLIFE) &&
-                  (config_pack_type() != PACK_TYPE_AFTER_TVG) &&
-                  g_cyclotron_controller.isRunning()));
-
-        {
-            AnimationConfig pc_config;
-            pc_config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
-            pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
-            pc_config.leds = g_powercell_leds;
-            pc_config.num_leds = NUM_LEDS_POWERCELL;
-            g_powercell_controller.play(std::make_unique<ScrollAnimation>(), pc_config);
-        }
-
-        while (sound_is_playing()) {
-            cy_speed_ramp_update();
-            if (auto* anim = g_cyclotron_controller.getCurrentAnimation()) {
-                uint32_t speed = 1000;
-                if (cy_speed_multiplier > 0) {
-                    speed = speed * (1 << 16) / cy_speed_multiplier;
-                }
-                anim->setSpeed(speed, 0);
-            }
-            show_leds();
-            if (!pu_sw() && !pack_pu_sw() && !wand_standby_sw()) break;
-            if (fire_sw()) break;
-            sleep_ms(20);
-        }
+        task_start(&startup_task, startup_step, STARTUP_SPIN_UP);
         break;
     }
 }
@@ -247,27 +266,43 @@ void pack_short_powerup_sound(bool afterlife_higher) {
 }
 
 /**
- * @brief Executes the main power-down sequence for the currently active pack type.
- * @details This function coordinates the sound and light animations for a full
- *          pack shutdown. It uses a predefined sequence from the `pack_powerdown_sequences`
- *          configuration table.
+ * @brief Power-down task: waits for the power-down sound and animations to
+ *        finish, then leaves the cyclotron speed and brightness reset for
+ *        the off state.
  */
-static void wait_for_sequence_end() {
-    do {
-        cy_speed_ramp_update();
-        if (auto* anim = g_cyclotron_controller.getCurrentAnimation()) {
-            uint32_t speed = 1000;
-            if (cy_speed_multiplier > 0) {
-                speed = speed * (1 << 16) / cy_speed_multiplier;
-            }
-            anim->setSpeed(speed, 0);
+static void powerdown_step(pack_task_t *task) {
+    switch (task->step) {
+    case POWERDOWN_WAIT:
+        if (g_powercell_controller.isRunning() || g_cyclotron_controller.isRunning() ||
+            sound_is_playing()) {
+            return;
         }
-        show_leds();
-        sleep_ms(20);
-    } while (g_powercell_controller.isRunning() || g_cyclotron_controller.isRunning() || sound_is_playing());
-    sleep_ms(10);
+        task_sleep_ms(task, 10, POWERDOWN_SETTLE);
+        return;
+    case POWERDOWN_SETTLE:
+        break;
+    }
+
+    if (config_pack_type() == PACK_TYPE_AFTERLIFE ||
+        config_pack_type() == PACK_TYPE_AFTER_TVG) {
+        // Ensure the multiplier is reset while the pack is off.
+        cy_speed_ramp_go(0, 0);
+        cy_speed_ramp_update();
+    }
+
+    // Reset LED brightness so off-state feedback like the ADJ1 rainbow
+    // remains visible after shutdown.
+    set_led_brightness(255, 0);
+    task_finish(task);
 }
 
+/**
+ * @brief Starts the main power-down sequence for the currently active pack type.
+ * @details This function coordinates the sound and light animations for a full
+ *          pack shutdown. It uses a predefined sequence from the `pack_powerdown_sequences`
+ *          configuration table. The sound and animations start here; waiting
+ *          for them runs as a task from `task_service()`.
+ */
 void pack_combo_powerdown(void) {
     const PackSequence* seq = &pack_powerdown_sequences[config_pack_type()];
     if (config_pack_type() == PACK_TYPE_AFTERLIFE ||
@@ -288,9 +323,9 @@ void pack_combo_powerdown(void) {
     pc_config.num_leds = NUM_LEDS_POWERCELL;
     if (seq->pc_pattern == PC_PATTERN_INSTANT_OFF) {
         g_powercell_controller.stop();
-        fill_solid(g_powercell_leds, NUM_LEDS_POWERCELL, CRGB::Black);
+        led_core_call([]() { fill_solid(g_powercell_leds, NUM_LEDS_POWERCELL, CRGB::Black); });
     } else {
-        g_powercell_controller.play(std::make_unique<DrainAnimation>(), pc_config);
+        g_powercell_controller.play<DrainAnimation>(pc_config);
     }
 
     AnimationConfig cy_config;
@@ -301,34 +336,31 @@ void pack_combo_powerdown(void) {
 
     if (config_pack_type() == PACK_TYPE_AFTERLIFE ||
         config_pack_type() == PACK_TYPE_AFTER_TVG) {
-        g_cyclotron_controller.enqueue(std::make_unique<ChangeColorAction>(CRGB::Black, seq->cy_ms, QUADRATIC_OUT));
-        g_cyclotron_controller.enqueue(std::make_unique<WaitAction>(seq->cy_ms));
-        g_cyclotron_controller.enqueue(std::make_unique<CallbackAction>([]() { g_cyclotron_controller.stop(); }));
+        // Fade the spin-down under a black overlay rather than recolouring
+        // the animation, then blank the ring once the overlay is opaque.
+        AnimationConfig tint_config = cy_config;
+        tint_config.color = CRGB::Black;
+        g_cyclotron_controller.playOverlay<SolidAnimation>(tint_config, LAYER_BLEND_ALPHA, 0);
+        g_cyclotron_controller.setOverlayOpacity(255, seq->cy_ms, QUADRATIC_OUT);
+        g_cyclotron_controller.enqueue<WaitAction>(seq->cy_ms);
+        g_cyclotron_controller.enqueue<CallbackAction>([]() {
+            g_cyclotron_controller.stop();
+            fill_solid(g_cyclotron_leds, g_cyclotron_led_count, CRGB::Black);
+        });
     } else {
         switch (seq->cy_pattern) {
         case CY_PATTERN_INSTANT_OFF:
             g_cyclotron_controller.stop();
-            fill_solid(g_cyclotron_leds, g_cyclotron_led_count, CRGB::Black);
+            led_core_call([]() { fill_solid(g_cyclotron_leds, g_cyclotron_led_count, CRGB::Black); });
             break;
         case CY_PATTERN_FADE_OUT:
-            g_cyclotron_controller.play(std::make_unique<FadeAnimation>(true), cy_config);
+            g_cyclotron_controller.play<FadeAnimation>(cy_config, true);
             break;
         case CY_PATTERN_RING_FADE_OUT:
-            g_cyclotron_controller.play(std::make_unique<CylonFadeOutAnimation>(), cy_config);
+            g_cyclotron_controller.play<CylonFadeOutAnimation>(cy_config);
             break;
         }
     }
 
-    wait_for_sequence_end();
-
-    if (config_pack_type() == PACK_TYPE_AFTERLIFE ||
-        config_pack_type() == PACK_TYPE_AFTER_TVG) {
-        // Ensure the multiplier is reset while the pack is off.
-        cy_speed_ramp_go(0, 0);
-        cy_speed_ramp_update();
-    }
-
-    // Reset LED brightness so off-state feedback like the ADJ1 rainbow
-    // remains visible after shutdown.
-    set_led_brightness(255, 0);
+    task_start(&powerdown_task, powerdown_step, POWERDOWN_WAIT);
 }
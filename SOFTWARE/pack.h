@@ -23,7 +23,9 @@ extern "C" {
  * @brief Executes the main power-up sequence for the currently active pack type.
  * @details This function coordinates the sound and light animations for a full
  *          pack startup. The specific sounds and light patterns are determined
- *          by the pack type selected via DIP switches.
+ *          by the pack type selected via DIP switches. Returns once the
+ *          sequence has started; the rest runs from `task_service()` and
+ *          ends early if the user fires or powers off.
  */
 void pack_combo_startup(void);
 
@@ -41,7 +43,8 @@ void pack_short_powerup_sound(bool afterlife_higher);
 /**
  * @brief Executes the main power-down sequence for the currently active pack type.
  * @details This function coordinates the sound and light animations for a full
- *          pack shutdown.
+ *          pack shutdown. Returns once the sequence has started; the rest
+ *          runs from `task_service()`.
  */
 void pack_combo_powerdown(void);
 
@@ -11,7 +11,7 @@
  */
 
 #include "pack_state.h"
-#include "Ramp.h"
+#include "RampFixed.h"
 
 #include "pack.h"
 #include "pack_helpers.h"
@@ -30,11 +30,14 @@
 #include "pack_config.h"
 #include "pico/stdlib.h"
 #include "animations.h"
-#include <memory>
+#include "led_core.h"
+#include "task_scheduler.h"
 
 #define STANDALONE_USE false
 #define AUTOVENT_MS_CYCLE 250
 #define FEEDBACK_DURATION_MS 5000
+/** Speed every cyclotron animation runs at on non-Afterlife packs (ms). */
+#define CY_FIXED_SPEED_MS 1000
 
 
 /** Global pack state context. */
@@ -45,10 +48,40 @@ PackContext pack_ctx = {
 };
 
 uint32_t cy_speed_multiplier = 1 << 16; // 16.16 fixed point for cyclotron speed control
-static rampUnsignedLong cy_speed_ramp(cy_speed_multiplier);
+static rampFixedUInt32 cy_speed_ramp(cy_speed_multiplier);
 static bool feedback_anim_needs_start = false;
 static uint32_t feedback_end_time = 0;
 
+/** The autovent sequence runs as a task so the main loop keeps going. */
+static pack_task_t autovent_task;
+
+/** Steps of the autovent task; each names what it waits for. */
+enum {
+    AUTOVENT_SIGNAL,        /**< Wand light alignment, then signal the wand. */
+    AUTOVENT_STOP_END,      /**< The overheat stop sound to end. */
+    AUTOVENT_WARN_END,      /**< The vent warning sound to end. */
+    AUTOVENT_VENT,          /**< Wand light alignment, then the vent. */
+    AUTOVENT_VENT_END,      /**< The vent to finish. */
+    AUTOVENT_FIRE_RELEASE,  /**< The fire button to be let go. */
+};
+
+/** Lengths of the two halves of the Afterlife fire cooldown (ms). */
+#define FIRE_COOLDOWN_SLOW_MS 1000
+#define FIRE_COOLDOWN_SPEED_UP_MS 4000
+
+/** Steps of the Afterlife fire cooldown, run by `PS_FIRE_COOLDOWN`. */
+enum {
+    FIRE_COOLDOWN_SLOW,     /**< Cyclotron slowing to half speed. */
+    FIRE_COOLDOWN_SPEED_UP, /**< Cyclotron back up to its idle speed. */
+};
+
+/** Where the fire cooldown is and when its current half started. */
+static struct {
+    uint8_t step;
+    uint32_t mark_ms;
+    uint32_t target_x;
+} fire_cooldown;
+
 void cy_speed_ramp_go(uint32_t target, unsigned long duration) {
     // Synchronize the ramp's starting point with the current multiplier so
     // mid-transition updates ramp smoothly from the present speed.
@@ -91,30 +124,166 @@ void feedback_request(void) {
     if (pack_state_get_state() != PS_FEEDBACK) {
         pack_state_set_state(PS_FEEDBACK);
         feedback_anim_needs_start = true;
-    } else if (auto* anim = g_cyclotron_controller.getCurrentAnimation()) {
+    } else if (g_cyclotron_controller.getCurrentAnimation()) {
         // Animation already running; update LED count and extend duration.
-        static_cast<FeedbackRainbowAnimation*>(anim)->updateConfig(cy_config, FEEDBACK_DURATION_MS);
+        g_cyclotron_controller.modify([cy_config](Animation& anim) {
+            static_cast<FeedbackRainbowAnimation&>(anim).updateConfig(cy_config, FEEDBACK_DURATION_MS);
+        });
     } else {
         feedback_anim_needs_start = true;
     }
 }
 
+/**
+ * @brief Starts the Afterlife cooldown after a shot: the cyclotron slows to
+ *        half its idle speed, then spins back up before the pack idles.
+ * @details The steps run from `PS_FIRE_COOLDOWN` on the main loop rather
+ *          than as callbacks on the cyclotron's action queue, which in
+ *          dual-core builds would run on the LED core and race the state
+ *          machine for the speed ramp, the sound driver and the pack state.
+ */
+static void fire_cooldown_start(void) {
+    fire_cooldown.target_x = afterlife_target_speed_x();
+    cy_speed_ramp_go(fire_cooldown.target_x << 15, FIRE_COOLDOWN_SLOW_MS);
+    fire_cooldown.step = FIRE_COOLDOWN_SLOW;
+    fire_cooldown.mark_ms = to_ms_since_boot(get_absolute_time());
+    pack_state_set_state(PS_FIRE_COOLDOWN);
+}
+
+/**
+ * @brief Advances the fire cooldown once its current half is over.
+ */
+static void fire_cooldown_step(void) {
+    const uint32_t now = to_ms_since_boot(get_absolute_time());
+    const uint32_t elapsed = now - fire_cooldown.mark_ms;
+
+    switch (fire_cooldown.step) {
+    case FIRE_COOLDOWN_SLOW:
+        if (elapsed >= FIRE_COOLDOWN_SLOW_MS) {
+            cy_speed_ramp_go(fire_cooldown.target_x << 16, FIRE_COOLDOWN_SPEED_UP_MS);
+            fire_cooldown.step = FIRE_COOLDOWN_SPEED_UP;
+            fire_cooldown.mark_ms = now;
+        }
+        break;
+    case FIRE_COOLDOWN_SPEED_UP:
+        if (elapsed >= FIRE_COOLDOWN_SPEED_UP_MS) {
+            sound_stop();
+            hum_monitor();
+            AnimationConfig config;
+            config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
+            config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
+            config.leds = g_powercell_leds;
+            config.num_leds = NUM_LEDS_POWERCELL;
+            g_powercell_controller.play<ScrollAnimation>(config);
+            pack_state_set_state(PS_IDLE);
+        }
+        break;
+    }
+}
+
+/**
+ * @brief Sets the speed of the cyclotron's animations for the pack type.
+ * @details On Afterlife packs the speed multiplier becomes the controller's
+ *          time scale, so the animations keep the speed they were started
+ *          with and are never reprogrammed; while it is zero (spun down)
+ *          the cyclotron runs in real time. The other packs never move the
+ *          multiplier and run every cyclotron animation at
+ *          `CY_FIXED_SPEED_MS`, whatever speed it was started with; the
+ *          controller only applies that after a new `play`.
+ */
+static void cy_speed_apply(void) {
+    cy_speed_ramp_update();
+    if (config_pack_type() == PACK_TYPE_AFTERLIFE ||
+        config_pack_type() == PACK_TYPE_AFTER_TVG) {
+        g_cyclotron_controller.setTimeScale(cy_speed_multiplier ? cy_speed_multiplier : 1u << 16);
+        return;
+    }
+    g_cyclotron_controller.setTimeScale(1u << 16);
+    g_cyclotron_controller.setSpeed(CY_FIXED_SPEED_MS);
+}
+
+/** @brief Takes the autovent strobe off the powercell and cyclotron. */
+static void autovent_strobe_stop(void) {
+    g_powercell_controller.stopOverlay();
+    g_cyclotron_controller.stopOverlay();
+}
+
+/**
+ * @brief Autovent task: signals the wand, plays the overheat and vent
+ *        warning sounds, vents, and returns the pack to idle once the fire
+ *        button is released.
+ * @details Powering the wand off skips whatever is left before the vent.
+ */
+static void autovent_step(pack_task_t *task) {
+    if (!pu_sw() && task->step < AUTOVENT_VENT) {
+        task->step = AUTOVENT_VENT_END;
+    }
+
+    switch (task->step) {
+    case AUTOVENT_SIGNAL:
+        nsignal_to_wandlights(true);
+        task->step = AUTOVENT_STOP_END;
+        // fall through
+    case AUTOVENT_STOP_END:
+        // A queued sound counts as playing until BUSY rises or times out.
+        if (sound_is_playing()) {
+            return;
+        }
+        sound_start_safely(54);
+        task->step = AUTOVENT_WARN_END;
+        // fall through
+    case AUTOVENT_WARN_END:
+        if (sound_is_playing()) {
+            return;
+        }
+        if ((!STANDALONE_USE) &&
+            ((config_pack_type() != PACK_TYPE_TVG_FADE) &&
+             (config_pack_type() != PACK_TYPE_AFTER_TVG))) {
+            task_sleep_ms(task, wandlights_align_ms(), AUTOVENT_VENT);
+            return;
+        }
+        // fall through
+    case AUTOVENT_VENT:
+        autovent_strobe_stop();
+        full_vent();
+        task->step = AUTOVENT_VENT_END;
+        return;
+    case AUTOVENT_VENT_END:
+        if (full_vent_is_running()) {
+            return;
+        }
+        autovent_strobe_stop();
+        nsignal_to_wandlights(false);
+        pack_state_set_state(PS_IDLE);
+        hum_monitor();
+        task->step = AUTOVENT_FIRE_RELEASE;
+        // fall through
+    case AUTOVENT_FIRE_RELEASE:
+        if (fire_sw() && pu_sw()) {
+            return;
+        }
+        break;
+    }
+    clear_song_toggle();
+    task_finish(task);
+}
+
 /**
  * @brief Main state machine processing function.
  * @details This function is called on every iteration of the main loop. It
  *          evaluates the current state and user inputs to determine and
- *          execute the correct pack behavior.
+ *          execute the correct pack behavior. While a start-up, power-down,
+ *          mode change or vent task is running it only steps that task,
+ *          which sees a fire or power-off request on the same pass and
+ *          hands back to the state machine as soon as it finishes.
  */
 void pack_state_process(void) {
-    song_monitor();
-    cy_speed_ramp_update();
-    if (auto* anim = g_cyclotron_controller.getCurrentAnimation()) {
-        uint32_t speed = 0;
-        if (cy_speed_multiplier > 0) {
-            speed = (1000 * (1 << 16)) / cy_speed_multiplier;
-        }
-        anim->setSpeed(speed, 0);
+    if (task_service()) {
+        cy_speed_apply();
+        return;
     }
+    song_monitor();
+    cy_speed_apply();
     if (pack_ctx.state != PS_OFF && party_mode_is_active()) {
         party_mode_stop();
     }
@@ -127,9 +296,11 @@ void pack_state_process(void) {
         if (!song_is_playing()) {
             if (!party_mode_is_active() &&
                 !g_powercell_controller.isRunning() && !g_cyclotron_controller.isRunning()) {
-                fill_solid(g_powercell_leds, NUM_LEDS_POWERCELL, CRGB::Black);
-                fill_solid(g_cyclotron_leds, NUM_LEDS_CYCLOTRON, CRGB::Black);
-                fill_solid(g_future_leds, NUM_LEDS_FUTURE, CRGB::Black);
+                led_core_call([]() {
+                    fill_solid(g_powercell_leds, NUM_LEDS_POWERCELL, CRGB::Black);
+                    fill_solid(g_cyclotron_leds, NUM_LEDS_CYCLOTRON, CRGB::Black);
+                    fill_solid(g_future_leds, NUM_LEDS_FUTURE, CRGB::Black);
+                });
             }
             ring_monitor();
             show_leds();
@@ -166,9 +337,7 @@ void pack_state_process(void) {
             AnimationConfig cy_config;
             cy_config.leds = g_cyclotron_leds;
             cy_config.num_leds = g_cyclotron_led_count;
-            g_cyclotron_controller.play(
-                std::make_unique<FeedbackRainbowAnimation>(FEEDBACK_DURATION_MS),
-                cy_config);
+            g_cyclotron_controller.play<FeedbackRainbowAnimation>(cy_config, FEEDBACK_DURATION_MS);
             feedback_anim_needs_start = false;
         }
         ring_monitor();
@@ -256,20 +425,18 @@ void pack_state_process(void) {
             vent_monitor();
         }
         break;
-    case PS_FIRE_COOLDOWN: {
+    case PS_FIRE_COOLDOWN:
         hum_monitor();
         adj_monitor();
-        // The fire cooldown sequence is now managed by the AnimationController's action queue.
-        // This state is now just a waiting state. We could add logic here to
-        // interrupt the sequence if needed.
-    } break;
+        fire_cooldown_step();
+        break;
     case PS_SLIME_FIRE:
-        if (!fire_sw()) {
+        if (!fire_sw() || !pu_sw()) {
             pack_state_set_state(PS_IDLE);
             fire_department(1);
             g_future_controller.stop();
             clear_fire_tap();
-            while (fire_sw()) {
+            while (fire_sw() && pu_sw()) {
                 sleep_ms(50);
             }
         } else if (temperature >=
@@ -280,7 +447,7 @@ void pack_state_process(void) {
             hum_monitor();
             cool_the_pack();
             adj_monitor();
-            while (fire_sw()) {
+            while (fire_sw() && pu_sw()) {
                 sleep_ms(50);
             }
             clear_song_toggle();
@@ -290,32 +457,11 @@ void pack_state_process(void) {
         adj_monitor();
         break;
     case PS_FIRE:
-        if (!fire_sw()) {
+        // Switching the wand off mid-shot ends it like letting go of fire;
+        // PS_IDLE then powers down to standby.
+        if (!fire_sw() || !pu_sw()) {
             if (config_pack_type() == PACK_TYPE_AFTERLIFE || config_pack_type() == PACK_TYPE_AFTER_TVG) {
-                pack_state_set_state(PS_FIRE_COOLDOWN);
-                const uint32_t slowdown_duration = 1000;
-                const uint32_t speedup_duration = 4000;
-                uint32_t target = afterlife_target_speed_x();
-                const uint32_t max_slow = target << 15;
-
-                g_cyclotron_controller.enqueue(std::make_unique<CallbackAction>([=]() { cy_speed_ramp_go(max_slow, slowdown_duration); }));
-                g_cyclotron_controller.enqueue(std::make_unique<WaitAction>(slowdown_duration));
-                g_cyclotron_controller.enqueue(std::make_unique<CallbackAction>([=]() {
-                    cy_speed_ramp_go(target << 16, speedup_duration);
-                }));
-                g_cyclotron_controller.enqueue(std::make_unique<WaitAction>(speedup_duration));
-                g_cyclotron_controller.enqueue(std::make_unique<CallbackAction>([]() {
-                    sound_stop();
-                    hum_monitor();
-                    AnimationConfig config;
-                    config.speed = adj_to_ms_cycle(PC_SPEED_DEFAULT, false, false);
-                    config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
-                    config.leds = g_powercell_leds;
-                    config.num_leds = NUM_LEDS_POWERCELL;
-                    g_powercell_controller.play(std::make_unique<ScrollAnimation>(), config);
-                    pack_state_set_state(PS_IDLE);
-                }));
-
+                fire_cooldown_start();
             } else {
                 pack_state_set_state(PS_IDLE);
             }
@@ -336,7 +482,7 @@ void pack_state_process(void) {
         adj_monitor();
         break;
     case PS_OVERHEAT:
-        if (fire_sw()) {
+        if (fire_sw() && pu_sw()) {
             if (temperature >=
                 pack_heat_settings[config_pack_type()].start_autovent) {
                 pack_state_set_state(PS_AUTOVENT);
@@ -356,7 +502,7 @@ void pack_state_process(void) {
         if (temperature <
             pack_heat_settings[config_pack_type()].start_beep) {
             pack_state_set_state(PS_IDLE);
-        } else if (fire_sw()) {
+        } else if (fire_sw() && pu_sw()) {
             pack_state_set_state(PS_OVERHEAT);
             fire_department(0);
             fire_department(2);
@@ -372,7 +518,8 @@ void pack_state_process(void) {
         pc_config.color = CRGB(powercell_color.r, powercell_color.g, powercell_color.b);
         pc_config.leds = g_powercell_leds;
         pc_config.num_leds = NUM_LEDS_POWERCELL;
-        g_powercell_controller.play(std::make_unique<StrobeAnimation>(), pc_config);
+        // The strobe covers the running animations until the vent.
+        g_powercell_controller.playOverlay<StrobeAnimation>(pc_config, LAYER_BLEND_ALPHA, 255);
 
         if ((config_pack_type() != PACK_TYPE_AFTERLIFE) &&
             (config_pack_type() != PACK_TYPE_AFTER_TVG)) {
@@ -381,29 +528,14 @@ void pack_state_process(void) {
             cy_config.color = CRGB(cyclotron_color.r, cyclotron_color.g, cyclotron_color.b);
             cy_config.leds = g_cyclotron_leds;
             cy_config.num_leds = g_cyclotron_led_count;
-            g_cyclotron_controller.play(std::make_unique<StrobeAnimation>(), cy_config);
+            g_cyclotron_controller.playOverlay<StrobeAnimation>(cy_config, LAYER_BLEND_ALPHA, 255);
         }
+        task_start(&autovent_task, autovent_step, AUTOVENT_SIGNAL);
         if ((!STANDALONE_USE) &&
             ((config_pack_type() == PACK_TYPE_TVG_FADE) ||
              (config_pack_type() == PACK_TYPE_AFTER_TVG))) {
-            sleep_align_wandlights();
-        }
-        nsignal_to_wandlights(true);
-        sound_wait_til_end(false, false);
-        sound_play_blocking(54, false, false);
-        if ((!STANDALONE_USE) &&
-            ((config_pack_type() != PACK_TYPE_TVG_FADE) &&
-             (config_pack_type() != PACK_TYPE_AFTER_TVG))) {
-            sleep_align_wandlights();
-        }
-        full_vent();
-        nsignal_to_wandlights(false);
-        pack_state_set_state(PS_IDLE);
-        hum_monitor();
-        while (fire_sw()) {
-            sleep_ms(50);
+            task_sleep_ms(&autovent_task, wandlights_align_ms(), AUTOVENT_SIGNAL);
         }
-        clear_song_toggle();
         break;
     }
     default:
@@ -74,7 +74,8 @@ extern PackContext pack_ctx;
  * @brief Cyclotron speed multiplier (16.16 fixed-point).
  * @details A value of `1 << 16` represents normal (1.0x) speed. This is used
  *          to briefly slow the cyclotron after firing on Afterlife packs
- *          without affecting other animations.
+ *          without affecting other animations. The state machine hands it to
+ *          `g_cyclotron_controller.setTimeScale()` on every pass.
  */
 extern uint32_t cy_speed_multiplier;
 
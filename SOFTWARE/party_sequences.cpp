@@ -17,15 +17,18 @@
 #include "future_sequences.h"
 #include "animations.h"
 #include "animation_controller.h"
+#include "led_core.h"
 #include "pack_state.h"
 #include "Arduino.h"
 #include <stdlib.h>
 
 #include <FastLED.h>
-#include <memory>
 
 static party_animation_t current_animation = PARTY_ANIMATION_RAINBOW_FADE;
 static bool party_mode_active = false;
+// LED-side copy of party_mode_active. It follows the state machine's flag
+// once the queued setup or teardown has run on the LED core.
+static bool party_mode_running = false;
 static PartyModeState g_party_state;
 
 
@@ -38,7 +41,7 @@ static PartyModeState g_party_state;
  *          themselves are updated by their respective controllers.
  */
 void party_mode_run(void) {
-    if (!party_mode_active) return;
+    if (!party_mode_running) return;
 
     // Update shared state based on current_animation
     switch (current_animation) {
@@ -89,37 +92,26 @@ void party_mode_run(void) {
 }
 
 /**
- * @brief Sets the active party mode animation.
- * @param animation The animation to activate.
+ * @brief Starts `animation` on all three controllers.
+ * @details Runs wherever the LEDs are driven from (see `led_core.h`).
  */
-void party_mode_set_animation(party_animation_t animation) {
-    if (animation >= PARTY_ANIMATION_COUNT) {
-        party_mode_stop();
-        return;
-    }
-
-    party_mode_stop(); // Stop current animations and clear LEDs
-
+static void party_mode_begin(party_animation_t animation) {
     current_animation = animation;
-    party_mode_active = true;
+    party_mode_running = true;
 
     // Initialize shared state
     g_party_state = PartyModeState(); // Reset to default
 
     // Set up animations on all three controllers
-    Animation* powercell_anim = nullptr;
-    Animation* cyclotron_anim = nullptr;
-    Animation* future_anim = nullptr;
-
     AnimationConfig pc_config = { g_powercell_leds, NUM_LEDS_POWERCELL };
     AnimationConfig cyc_config = { g_cyclotron_leds, g_cyclotron_led_count };
     AnimationConfig fut_config = { g_future_leds, NUM_LEDS_FUTURE };
 
     switch (animation) {
         case PARTY_ANIMATION_RAINBOW_FADE:
-            powercell_anim = new PartyRainbowFadeAnimation(&g_party_state);
-            cyclotron_anim = new PartyRainbowFadeAnimation(&g_party_state);
-            future_anim = new PartyRainbowFadeAnimation(&g_party_state);
+            g_powercell_controller.play<PartyRainbowFadeAnimation>(pc_config, &g_party_state);
+            g_cyclotron_controller.play<PartyRainbowFadeAnimation>(cyc_config, &g_party_state);
+            g_future_controller.play<PartyRainbowFadeAnimation>(fut_config, &g_party_state);
             break;
         case PARTY_ANIMATION_CYLON_SCANNER:
             {
@@ -136,16 +128,16 @@ void party_mode_set_animation(party_animation_t animation) {
                 pc_config.bounce = true;
                 cyc_config.bounce = true;
                 fut_config.bounce = true;
-                powercell_anim = new CylonAnimation();
-                cyclotron_anim = new CylonAnimation();
-                future_anim = new CylonAnimation();
+                g_powercell_controller.play<CylonAnimation>(pc_config);
+                g_cyclotron_controller.play<CylonAnimation>(cyc_config);
+                g_future_controller.play<CylonAnimation>(fut_config);
                 g_party_state.sparkle_time = millis(); // Initialize timer
             }
             break;
         case PARTY_ANIMATION_RANDOM_SPARKLE:
-            powercell_anim = new PartyRandomSparkleAnimation(&g_party_state, 0);
-            cyclotron_anim = new PartyRandomSparkleAnimation(&g_party_state, 1);
-            future_anim = new PartyRandomSparkleAnimation(&g_party_state, 2);
+            g_powercell_controller.play<PartyRandomSparkleAnimation>(pc_config, &g_party_state, 0);
+            g_cyclotron_controller.play<PartyRandomSparkleAnimation>(cyc_config, &g_party_state, 1);
+            g_future_controller.play<PartyRandomSparkleAnimation>(fut_config, &g_party_state, 2);
             break;
         case PARTY_ANIMATION_BEAT_METER:
             {
@@ -159,18 +151,45 @@ void party_mode_set_animation(party_animation_t animation) {
                 cyc_config.color = g_party_state.beat_meter_color;
                 fut_config.color = g_party_state.beat_meter_color;
 
-                powercell_anim = new BeatMeterAnimation(&g_party_state);
-                cyclotron_anim = new BeatMeterAnimation(&g_party_state);
-                future_anim = new BeatMeterAnimation(&g_party_state);
+                g_powercell_controller.play<BeatMeterAnimation>(pc_config, &g_party_state);
+                g_cyclotron_controller.play<BeatMeterAnimation>(cyc_config, &g_party_state);
+                g_future_controller.play<BeatMeterAnimation>(fut_config, &g_party_state);
             }
             break;
         case PARTY_ANIMATION_COUNT:
             break;
     }
+}
+
+/**
+ * @brief Stops the party animations and clears all three strips.
+ * @details Runs wherever the LEDs are driven from (see `led_core.h`).
+ */
+static void party_mode_end(void) {
+    party_mode_running = false;
+    g_powercell_controller.stop();
+    g_cyclotron_controller.stop();
+    g_future_controller.stop();
+
+    fill_solid(g_powercell_leds, NUM_LEDS_POWERCELL, CRGB::Black);
+    fill_solid(g_cyclotron_leds, g_cyclotron_led_count, CRGB::Black);
+    fill_solid(g_future_leds, NUM_LEDS_FUTURE, CRGB::Black);
+}
+
+/**
+ * @brief Sets the active party mode animation.
+ * @param animation The animation to activate.
+ */
+void party_mode_set_animation(party_animation_t animation) {
+    if (animation >= PARTY_ANIMATION_COUNT) {
+        party_mode_stop();
+        return;
+    }
+
+    party_mode_stop(); // Stop current animations and clear LEDs
 
-    if (powercell_anim) g_powercell_controller.play(std::unique_ptr<Animation>(powercell_anim), pc_config);
-    if (cyclotron_anim) g_cyclotron_controller.play(std::unique_ptr<Animation>(cyclotron_anim), cyc_config);
-    if (future_anim) g_future_controller.play(std::unique_ptr<Animation>(future_anim), fut_config);
+    party_mode_active = true;
+    led_core_call([animation]() { party_mode_begin(animation); });
 }
 
 /**
@@ -182,13 +201,7 @@ void party_mode_stop(void) {
     }
 
     party_mode_active = false;
-    g_powercell_controller.stop();
-    g_cyclotron_controller.stop();
-    g_future_controller.stop();
-
-    fill_solid(g_powercell_leds, NUM_LEDS_POWERCELL, CRGB::Black);
-    fill_solid(g_cyclotron_leds, g_cyclotron_led_count, CRGB::Black);
-    fill_solid(g_future_leds, NUM_LEDS_FUTURE, CRGB::Black);
+    led_core_call([]() { party_mode_end(); });
 }
 
 /**
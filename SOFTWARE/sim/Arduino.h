@@ -0,0 +1,9 @@
+#pragma once
+// Arduino.h for the simulator, so shared libraries such as RAMP build
+// against the virtual clock in arduino_stubs.h.
+#include <cstdint>
+#include <cmath>
+#include "arduino_stubs.h"
+
+using boolean = bool;
+using byte = uint8_t;
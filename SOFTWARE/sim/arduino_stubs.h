@@ -1,14 +1,18 @@
 #pragma once
-#include <chrono>
-#include <thread>
 #include <cstdint>
 
-inline uint32_t millis() {
-  using namespace std::chrono;
-  static const auto start = steady_clock::now();
-  return (uint32_t)duration_cast<milliseconds>(steady_clock::now() - start).count();
-}
+// Virtual clock. millis(), micros() and delay() never touch the wall clock:
+// time only moves when the sketch or the simulator loop calls delay() or
+// sim_clock_advance_us(), so a clip renders as fast as the CPU allows and
+// every run produces the same frames. RAMP reads the same clock through the
+// simulator's Arduino.h. Each thread has its own clock, so batch jobs do not
+// see each other's time.
+inline thread_local uint64_t g_sim_clock_us = 0;
 
-inline void delay(uint32_t ms) {
-  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
-}
+inline void sim_clock_advance_us(uint64_t us) { g_sim_clock_us += us; }
+
+inline uint32_t millis() { return (uint32_t)(g_sim_clock_us / 1000); }
+
+inline uint32_t micros() { return (uint32_t)g_sim_clock_us; }
+
+inline void delay(uint32_t ms) { sim_clock_advance_us((uint64_t)ms * 1000); }
@@ -1,22 +1,36 @@
 #include "fastled_shim.h"
+#include "sim_env.h"
 #include <vector>
 #include <cstdlib>
 #include <string>
 #include <cctype>
 #include <cmath>
 
-static int NUM_LEDS = 16;
-static std::string g_anim = "example";
-static std::string g_mode;
-static std::string g_base;
-static std::vector<CRGB> leds;
-static CRGB g_color(255, 255, 255);
-static bool g_rainbow = false;
-static int g_total_frames = 360;
+// Thread-local so the batch renderer can run one sketch per thread; setup()
+// resets all of it for each clip.
+static thread_local std::string g_anim = "example";
+static thread_local std::string g_mode;
+static thread_local std::string g_base;
+static thread_local CRGB g_color(255, 255, 255);
+static thread_local bool g_rainbow = false;
+static thread_local int g_total_frames = 360;
+static thread_local int g_loop_frame = 0;
+
+// One registered LED strip and the animation drawn on it.
+struct SketchStrip {
+  std::vector<CRGB> leds;
+  std::string base;
+};
+static thread_local std::vector<SketchStrip> g_strips;
+
+// LAYOUT=pack drives the whole pack at once, with these strip lengths from
+// the firmware and LED_COUNT as the cyclotron ring.
+static const int PACK_POWERCELL_LEDS = 15;
+static const int PACK_FUTURE_LEDS = 18;
 
 int animation_duration_frames() { return g_total_frames; }
 
-static void fade_all(uint8_t amount) {
+static void fade_all(std::vector<CRGB>& leds, uint8_t amount) {
   for (auto &c : leds) {
     c.r = c.r * amount / 255;
     c.g = c.g * amount / 255;
@@ -48,7 +62,8 @@ static CRGB wheel(uint8_t pos) {
   return CRGB(pos * 3, 255 - pos * 3, 0);
 }
 
-static void render_powercell_sequence(const std::string &mode, int frame) {
+static void render_powercell_sequence(std::vector<CRGB>& leds, const std::string &mode, int frame) {
+  const int NUM_LEDS = int(leds.size());
   // 6s total: 1s fill, 4s scroll, 1s drain
   for (auto &c : leds) c = CRGB(0,0,0);
   if (frame < 60) {
@@ -67,7 +82,8 @@ static void render_powercell_sequence(const std::string &mode, int frame) {
   }
 }
 
-static void render_cyclotron_sequence(const std::string &mode, int frame) {
+static void render_cyclotron_sequence(std::vector<CRGB>& leds, const std::string &mode, int frame) {
+  const int NUM_LEDS = int(leds.size());
   // 6s: 1s fill, 4s rotation, 1s drain
   for (auto &c : leds) c = CRGB(0,0,0);
   if (frame < 60) {
@@ -91,7 +107,8 @@ static void render_cyclotron_sequence(const std::string &mode, int frame) {
   }
 }
 
-static void render_future_sequence(const std::string &mode, int frame) {
+static void render_future_sequence(std::vector<CRGB>& leds, const std::string &mode, int frame) {
+  const int NUM_LEDS = int(leds.size());
   // 6s: 1s fade in, 4s rotate, 1s fade out
   if (frame < 60) {
     uint8_t level = frame * 255 / 60;
@@ -113,10 +130,18 @@ static void render_future_sequence(const std::string &mode, int frame) {
 }
 
 void setup() {
-  if (const char* n = std::getenv("LED_COUNT")) {
-    NUM_LEDS = std::atoi(n);
+  int num_leds = 16;
+  g_anim = "example";
+  g_mode.clear();
+  g_base.clear();
+  g_color = CRGB(255, 255, 255);
+  g_rainbow = false;
+  g_loop_frame = 0;
+  sim_srand(1);
+  if (const char* n = sim_getenv("LED_COUNT")) {
+    num_leds = std::atoi(n);
   }
-  if (const char* a = std::getenv("ANIMATION_NAME")) {
+  if (const char* a = sim_getenv("ANIMATION_NAME")) {
     g_anim = a;
     auto pos = g_anim.find('_');
     if (pos != std::string::npos && g_anim.rfind("party_",0) != 0) {
@@ -128,7 +153,7 @@ void setup() {
   } else {
     g_base = g_anim;
   }
-  if (const char* c = std::getenv("COLOR")) {
+  if (const char* c = sim_getenv("COLOR")) {
     std::string cs(c);
     for (char& ch : cs) ch = std::tolower(static_cast<unsigned char>(ch));
     if (cs == "rainbow" || cs == "multicolor") {
@@ -137,13 +162,32 @@ void setup() {
       g_color = parse_color(cs);
     }
   }
-  leds.resize(NUM_LEDS);
-  FastLED::addLeds(leds.data(), NUM_LEDS);
+  const char* layout = sim_getenv("LAYOUT");
+  if (layout && std::string(layout) == "pack") {
+    // "<mode>_sequence" runs each strip's own start-up sequence; any other
+    // animation runs on all three strips in step.
+    bool sequence = g_base == "sequence";
+    g_strips.assign(3, SketchStrip());
+    g_strips[0].leds.assign(PACK_POWERCELL_LEDS, CRGB());
+    g_strips[0].base = sequence ? "powercell_sequence" : g_base;
+    g_strips[1].leds.assign(num_leds, CRGB());
+    g_strips[1].base = sequence ? "cyclotron_sequence" : g_base;
+    g_strips[2].leds.assign(PACK_FUTURE_LEDS, CRGB());
+    g_strips[2].base = sequence ? "future_sequence" : g_base;
+  } else {
+    g_strips.assign(1, SketchStrip());
+    g_strips[0].leds.assign(num_leds, CRGB());
+    g_strips[0].base = g_base;
+  }
+  for (SketchStrip& strip : g_strips) {
+    FastLED::addLeds(strip.leds.data(), int(strip.leds.size()));
+  }
   FastLED::setBrightness(200);
 
   if (g_base == "powercell_sequence" ||
       g_base == "cyclotron_sequence" ||
-      g_base == "future_sequence") {
+      g_base == "future_sequence" ||
+      g_base == "sequence") {
     g_total_frames = 360; // 6s startup+idle+shutdown
   } else if (g_base.rfind("party_", 0) == 0) {
     g_total_frames = 480; // 8s preview for party loops
@@ -152,25 +196,25 @@ void setup() {
   }
 }
 
-void loop() {
-  static int frame = 0;
+static void draw_strip(std::vector<CRGB>& leds, const std::string& base, int frame) {
+  const int NUM_LEDS = int(leds.size());
 
-  if (g_base == "party_rainbow_fade") {
+  if (base == "party_rainbow_fade") {
     for (int i=0;i<NUM_LEDS;++i)
       leds[i] = wheel((i*256/NUM_LEDS + frame*4) & 0xFF);
 
-  } else if (g_base == "party_cylon_scanner") {
-    fade_all(200);
+  } else if (base == "party_cylon_scanner") {
+    fade_all(leds, 200);
     int pos = frame % (NUM_LEDS*2);
     if (pos >= NUM_LEDS) pos = 2*NUM_LEDS - pos - 1;
     leds[pos] = g_rainbow ? wheel((frame*8)&0xFF) : g_color;
 
-  } else if (g_base == "party_random_sparkle") {
-    fade_all(180);
-    int idx = std::rand() % NUM_LEDS;
-    leds[idx] = g_rainbow ? wheel(std::rand() & 0xFF) : g_color;
+  } else if (base == "party_random_sparkle") {
+    fade_all(leds, 180);
+    int idx = sim_rand() % NUM_LEDS;
+    leds[idx] = g_rainbow ? wheel(sim_rand() & 0xFF) : g_color;
 
-  } else if (g_base == "party_beat_meter") {
+  } else if (base == "party_beat_meter") {
     for (auto &c : leds) c = CRGB(0,0,0);
     double s = (std::sin(frame/10.0)+1.0)/2.0;
     int level = static_cast<int>(s * NUM_LEDS);
@@ -182,17 +226,17 @@ void loop() {
     leds[0] = g_rainbow ? wheel((frame*8)&0xFF) : g_color;
 
   } else if (g_anim == "rotate_fade") {
-    fade_all(220);
+    fade_all(leds, 220);
     for (int i=NUM_LEDS-1;i>0;--i) leds[i]=leds[i-1];
     leds[0] = g_rainbow ? wheel((frame*8)&0xFF) : g_color;
 
   } else if (g_anim == "slime") {
-    fade_all(200);
+    fade_all(leds, 200);
     int drop = frame % NUM_LEDS;
     leds[drop] = g_rainbow ? wheel((frame*8)&0xFF) : g_color;
 
   } else if (g_anim == "cylon_fade_out") {
-    fade_all(200);
+    fade_all(leds, 200);
     int pos = frame % (NUM_LEDS*2);
     if (pos >= NUM_LEDS) pos = 2*NUM_LEDS - pos -1;
     leds[pos] = g_rainbow ? wheel((frame*8)&0xFF) : g_color;
@@ -217,7 +261,7 @@ void loop() {
       leds[i] = on ? (g_rainbow ? wheel((i*256/NUM_LEDS + frame*8)&0xFF) : g_color) : CRGB(0,0,0);
 
   } else if (g_anim == "waterfall") {
-    fade_all(200);
+    fade_all(leds, 200);
     for (int i=NUM_LEDS-1;i>0;--i) leds[i]=leds[i-1];
     leds[0] = g_rainbow ? wheel((frame*8)&0xFF) : g_color;
 
@@ -238,14 +282,14 @@ void loop() {
       leds[i] = CRGB(base.r*s, base.g*s, base.b*s);
     }
 
-  } else if (g_base == "powercell_sequence") {
-    render_powercell_sequence(g_mode, frame);
+  } else if (base == "powercell_sequence") {
+    render_powercell_sequence(leds, g_mode, frame);
 
-  } else if (g_base == "cyclotron_sequence") {
-    render_cyclotron_sequence(g_mode, frame);
+  } else if (base == "cyclotron_sequence") {
+    render_cyclotron_sequence(leds, g_mode, frame);
 
-  } else if (g_base == "future_sequence") {
-    render_future_sequence(g_mode, frame);
+  } else if (base == "future_sequence") {
+    render_future_sequence(leds, g_mode, frame);
 
   } else if (g_anim == "party_powercell") {
     for (int i=0;i<NUM_LEDS;++i)
@@ -268,8 +312,13 @@ void loop() {
       leds[i] = g_rainbow ? wheel((i*256/NUM_LEDS + frame*8) & 0xFF) : g_color;
     }
   }
+}
 
+void loop() {
+  for (SketchStrip& strip : g_strips) {
+    draw_strip(strip.leds, strip.base, g_loop_frame);
+  }
   FastLED::show();
-  ++frame;
+  ++g_loop_frame;
 }
 
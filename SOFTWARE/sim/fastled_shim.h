@@ -50,29 +50,42 @@ struct CRGB {
 
 inline const CRGB CRGB::Black = CRGB(0, 0, 0);
 
+// Controller state is per thread so the batch renderer can run several
+// sketches at once. Every addLeds() call registers another controller, as
+// the pack registers its powercell, cyclotron and future strips, and show()
+// hands all of them to the recorder in registration order.
 namespace FastLED {
-  inline CRGB* g_leds = nullptr;
-  inline int g_nleds = 0;
-  inline uint8_t g_brightness = 255;
+  struct Controller {
+    CRGB* leds;
+    int nleds;
+  };
+
+  inline thread_local std::vector<Controller> g_controllers;
+  inline thread_local uint8_t g_brightness = 255;
 
   template <typename... Args>
   inline void addLeds(CRGB* leds, int n) {
-    g_leds = leds;
-    g_nleds = n;
+    g_controllers.push_back({leds, n});
   }
 
   inline void setBrightness(uint8_t b) { g_brightness = b; }
 
-  using ShowCallback = std::function<void(const CRGB*, int, uint8_t)>;
-  inline ShowCallback g_show_cb = nullptr;
+  using ShowCallback = std::function<void(const Controller*, int, uint8_t)>;
+  inline thread_local ShowCallback g_show_cb = nullptr;
 
   inline void show() {
-    if (g_show_cb) g_show_cb(g_leds, g_nleds, g_brightness);
+    if (g_show_cb) g_show_cb(g_controllers.data(), int(g_controllers.size()), g_brightness);
   }
 
   inline void clear(bool force=false) {
-    if (!g_leds) return;
-    for (int i=0;i<g_nleds;++i) g_leds[i] = CRGB::Black;
+    for (const Controller& c : g_controllers)
+      for (int i=0;i<c.nleds;++i) c.leds[i] = CRGB::Black;
+  }
+
+  // Forgets every controller, for the next sketch run on this thread.
+  inline void reset() {
+    g_controllers.clear();
+    g_brightness = 255;
   }
 }
 
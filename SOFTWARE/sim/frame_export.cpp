@@ -0,0 +1,108 @@
+// Exports a frame stream written by sim_led (FRAME_STREAM=...) as PPM
+// images, an MP4 or a GIF; a stream of several strips becomes one composite
+// image per frame. Each frame is rendered once and handed to every
+// requested output. The GIF is encoded in process (GifWriter); the MP4 is
+// encoded by ffmpeg reading raw RGB from a pipe, so no intermediate images
+// touch the disk.
+//
+//   sim_frames <stream> [--ppm DIR] [--mp4 FILE] [--gif FILE]
+#include "frame_recorder.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static void usage() {
+  std::fprintf(stderr,
+               "usage: sim_frames <stream> [--ppm DIR] [--mp4 FILE] [--gif FILE]\n");
+}
+
+static FILE* open_ffmpeg(const std::string& args, int w, int h, int fps) {
+  std::string cmd = "ffmpeg -loglevel error -y -f rawvideo -pix_fmt rgb24 -s " +
+                    std::to_string(w) + "x" + std::to_string(h) +
+                    " -framerate " + std::to_string(fps) + " -i - " + args;
+  FILE* p = popen(cmd.c_str(), "w");
+  if (!p) std::fprintf(stderr, "cannot run ffmpeg\n");
+  return p;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    usage();
+    return 2;
+  }
+  std::string ppm_dir, mp4_path, gif_path;
+  for (int i = 2; i < argc; ++i) {
+    if (i + 1 < argc && std::strcmp(argv[i], "--ppm") == 0) {
+      ppm_dir = argv[++i];
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--mp4") == 0) {
+      mp4_path = argv[++i];
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--gif") == 0) {
+      gif_path = argv[++i];
+    } else {
+      usage();
+      return 2;
+    }
+  }
+
+  FrameStreamReader in;
+  if (!in.open(argv[1])) {
+    std::fprintf(stderr, "%s: not a frame stream\n", argv[1]);
+    return 1;
+  }
+  const FrameStreamInfo& info = in.info();
+  if (!ppm_dir.empty()) std::filesystem::create_directories(ppm_dir);
+
+  std::vector<uint8_t> rgb;
+  FrameImage img;
+  // The GIF palette is every LED colour in the stream, so read it once
+  // up front.
+  GifPalette palette;
+  if (!gif_path.empty()) {
+    FrameStreamReader scan;
+    scan.open(argv[1]);
+    while (scan.next(rgb)) palette.add(rgb.data(), info.nleds);
+  }
+
+  FILE* mp4 = nullptr;
+  GifWriter gif;
+  bool gif_failed = false;
+  int frame = 0;
+  while (in.next(rgb)) {
+    render_frame(rgb.data(), info.strips, img);
+    if (frame == 0) {
+      if (!mp4_path.empty()) {
+        mp4 = open_ffmpeg("-c:v libx264 -pix_fmt yuv420p '" + mp4_path + "'",
+                          img.w, img.h, info.fps);
+      }
+      if (!gif_path.empty()) gif_failed = !gif.open(gif_path, img.w, img.h, palette.rgb());
+    }
+    if (!ppm_dir.empty()) {
+      char name[64];
+      std::snprintf(name, sizeof(name), "/frame_%05d.ppm", frame);
+      write_ppm(ppm_dir + name, img);
+    }
+    if (mp4) std::fwrite(img.rgb.data(), 1, img.rgb.size(), mp4);
+    if (gif.is_open()) {
+      // Frame delays are whole hundredths; spread the remainder so the
+      // clip keeps its length.
+      gif.add(img.rgb, uint32_t((frame + 1) * 100 / info.fps - frame * 100 / info.fps));
+    }
+    ++frame;
+  }
+
+  int status = 0;
+  if (mp4 && pclose(mp4) != 0) status = 1;
+  if (!gif.close() || gif_failed) status = 1;
+  if (!mp4_path.empty() && !mp4) status = 1;
+  std::string layout;
+  for (const StripInfo& strip : info.strips) {
+    if (!layout.empty()) layout += " + ";
+    layout += std::to_string(strip.nleds) +
+              (strip.layout == Layout::Ring ? " ring" : " strip");
+  }
+  std::printf("%d frames, %d LEDs (%s), %d fps\n", frame, info.nleds,
+              layout.c_str(), info.fps);
+  return status;
+}
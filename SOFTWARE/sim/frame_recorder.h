@@ -1,72 +1,238 @@
 #pragma once
+#include <algorithm>
+#include <deque>
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <cstdio>
 #include <filesystem>
 #include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
 
 enum class Layout { Strip, Ring };
-constexpr double PI = 3.14159265358979323846;
+// Not PI: FastLED defines that as a macro, and the host harness includes both.
+constexpr double RING_PI = 3.14159265358979323846;
 
-inline bool write_strip_ppm(const std::string& path,
-                            const uint8_t* rgb,
-                            int nleds,
-                            int scale=24) {
-  const int w = nleds * scale;
-  const int h = scale;
-  FILE* f = std::fopen(path.c_str(), "wb");
-  if (!f) return false;
-  std::fprintf(f, "P6\n%d %d\n255\n", w, h);
-  for (int y=0; y<h; ++y) {
-    for (int x=0; x<w; ++x) {
-      int i = x / scale;
-      const uint8_t* p = rgb + i*3;
-      std::fputc(p[0], f);
-      std::fputc(p[1], f);
-      std::fputc(p[2], f);
+// An RGB24 image that is redrawn frame after frame. `background` records
+// which arrangement's background `rgb` already holds, by value rather than
+// by buffer address, so a frame of the same arrangement only rewrites its
+// LEDs and anything else starts from a cleared image. It is empty until the
+// first frame. Draw into `rgb` only through the render functions, or clear
+// `background` after drawing into it yourself.
+struct FrameImage {
+  std::vector<uint8_t> rgb;
+  int w = 0;
+  int h = 0;
+  std::vector<int> background;
+};
+
+// Tags for FrameImage::background: the first value, then the arrangement.
+constexpr int BACKGROUND_RING = 1;      // then LED count and scale
+constexpr int BACKGROUND_COMPOSITE = 2; // then each strip's width and height
+
+// Sizes img for a w x h frame whose background is `key`, clearing it unless
+// it already holds that background.
+inline void prepare_background(FrameImage& img, int w, int h,
+                               const std::vector<int>& key) {
+  img.w = w;
+  img.h = h;
+  if (img.background != key || img.rgb.size() != size_t(w) * h * 3) {
+    img.rgb.assign(size_t(w) * h * 3, 0);
+    img.background = key;
+  }
+}
+
+// Renders one frame of nleds RGB triples into an RGB24 image.
+inline void render_strip(const uint8_t* rgb,
+                         int nleds,
+                         FrameImage& img,
+                         int scale=24) {
+  img.w = nleds * scale;
+  img.h = scale;
+  img.rgb.resize(size_t(img.w) * img.h * 3);
+  // Every pixel is rewritten, so there is no background to keep.
+  img.background.clear();
+  uint8_t* row = img.rgb.data();
+  for (int i=0; i<nleds; ++i) {
+    for (int dx=0; dx<scale; ++dx) {
+      uint8_t* q = row + (i*scale + dx) * 3;
+      q[0] = rgb[i*3+0];
+      q[1] = rgb[i*3+1];
+      q[2] = rgb[i*3+2];
     }
   }
-  std::fclose(f);
-  return true;
+  // Every row is the same.
+  for (int y=1; y<img.h; ++y) {
+    std::copy(row, row + size_t(img.w) * 3, row + size_t(y) * img.w * 3);
+  }
 }
 
-inline bool write_ring_ppm(const std::string& path,
-                           const uint8_t* rgb,
-                           int nleds,
-                           int scale=16) {
-  const int w = 16 * scale;
-  const int h = 16 * scale;
-  std::vector<uint8_t> img(w*h*3, 0);
-  const double radius = (std::min(w, h) - scale*2) / 2.0;
-  const double cx = w / 2.0;
-  const double cy = h / 2.0;
+// Where each LED's square lands in a ring image: per LED, the clipped row
+// spans it covers. Depends only on (LED count, scale), so it is built once
+// per pair and reused for every frame.
+struct RingSprites {
+  struct Span {
+    uint32_t offset; // byte offset of the first pixel
+    uint16_t pixels;
+  };
+  int nleds = 0;
+  int scale = 0;
+  int w = 0;
+  int h = 0;
+  std::vector<uint32_t> first; // spans of LED i: [first[i], first[i+1])
+  std::vector<Span> spans;
+};
+
+inline const RingSprites& ring_sprites(int nleds, int scale) {
+  // A deque, so references handed out stay valid as pairs are added.
+  static thread_local std::deque<RingSprites> cache;
+  for (const RingSprites& s : cache) {
+    if (s.nleds == nleds && s.scale == scale) return s;
+  }
+  RingSprites s;
+  s.nleds = nleds;
+  s.scale = scale;
+  s.w = 16 * scale;
+  s.h = 16 * scale;
+  const double radius = (std::min(s.w, s.h) - scale*2) / 2.0;
+  const double cx = s.w / 2.0;
+  const double cy = s.h / 2.0;
   for (int i=0; i<nleds; ++i) {
-    double ang = 2.0 * PI * i / nleds;
-    double ledx = cx + radius * std::cos(ang);
-    double ledy = cy + radius * std::sin(ang);
-    for (int dy=0; dy<scale; ++dy) {
-      for (int dx=0; dx<scale; ++dx) {
-        int x = static_cast<int>(ledx) + dx - scale/2;
-        int y = static_cast<int>(ledy) + dy - scale/2;
-        if (x>=0 && x<w && y>=0 && y<h) {
-          size_t idx = (y*w + x) * 3;
-          const uint8_t* p = rgb + i*3;
-          img[idx+0] = p[0];
-          img[idx+1] = p[1];
-          img[idx+2] = p[2];
-        }
-      }
+    s.first.push_back(uint32_t(s.spans.size()));
+    double ang = 2.0 * RING_PI * i / nleds;
+    int x0 = static_cast<int>(cx + radius * std::cos(ang)) - scale/2;
+    int y0 = static_cast<int>(cy + radius * std::sin(ang)) - scale/2;
+    int xa = std::max(x0, 0);
+    int xb = std::min(x0 + scale, s.w);
+    if (xa >= xb) continue;
+    for (int y=std::max(y0, 0); y<std::min(y0 + scale, s.h); ++y) {
+      s.spans.push_back({uint32_t((size_t(y)*s.w + xa) * 3), uint16_t(xb - xa)});
+    }
+  }
+  s.first.push_back(uint32_t(s.spans.size()));
+  cache.push_back(std::move(s));
+  return cache.back();
+}
+
+// Only the LED squares change between frames of the same ring, so once img
+// holds that ring's background just the squares are rewritten.
+inline void render_ring(const uint8_t* rgb,
+                        int nleds,
+                        FrameImage& img,
+                        int scale=16) {
+  const RingSprites& sprites = ring_sprites(nleds, scale);
+  static thread_local std::vector<int> key;
+  key.assign({BACKGROUND_RING, nleds, scale});
+  prepare_background(img, sprites.w, sprites.h, key);
+  static thread_local std::vector<uint8_t> fill;
+  fill.resize(size_t(scale) * 3);
+  for (int i=0; i<nleds; ++i) {
+    const uint8_t* p = rgb + i*3;
+    for (int x=0; x<scale; ++x) {
+      fill[x*3+0] = p[0];
+      fill[x*3+1] = p[1];
+      fill[x*3+2] = p[2];
+    }
+    for (uint32_t k=sprites.first[i]; k<sprites.first[i+1]; ++k) {
+      const RingSprites::Span& span = sprites.spans[k];
+      std::memcpy(&img.rgb[span.offset], fill.data(), size_t(span.pixels) * 3);
+    }
+  }
+}
+
+inline void render_frame(const uint8_t* rgb,
+                         int nleds,
+                         Layout layout,
+                         FrameImage& img) {
+  if (layout == Layout::Ring) {
+    render_ring(rgb, nleds, img);
+  } else {
+    render_strip(rgb, nleds, img);
+  }
+}
+
+// One strip of a composite frame. A composite frame's RGB data is each
+// strip's LEDs in turn, in the order the strips were registered.
+struct StripInfo {
+  int nleds;
+  Layout layout;
+};
+
+// Gap between the strips of a composite image, in pixels.
+constexpr int COMPOSITE_GAP = 8;
+
+// Renders several strips into one image, stacked top to bottom and centred,
+// e.g. the pack's powercell bar, cyclotron ring and future strip.
+inline void render_frame(const uint8_t* rgb,
+                         const std::vector<StripInfo>& strips,
+                         FrameImage& img) {
+  if (strips.size() == 1) {
+    render_frame(rgb, strips[0].nleds, strips[0].layout, img);
+    return;
+  }
+  // One image per strip, so the ring renderer can keep its background.
+  static thread_local std::vector<FrameImage> parts;
+  static thread_local std::vector<int> key;
+  parts.resize(strips.size());
+  key.assign({BACKGROUND_COMPOSITE});
+  int w = 0;
+  int h = 0;
+  for (size_t s=0; s<strips.size(); ++s) {
+    render_frame(rgb, strips[s].nleds, strips[s].layout, parts[s]);
+    rgb += strips[s].nleds * 3;
+    key.push_back(parts[s].w);
+    key.push_back(parts[s].h);
+    w = std::max(w, parts[s].w);
+    h += parts[s].h + (s ? COMPOSITE_GAP : 0);
+  }
+  // The gaps only need clearing when the arrangement changed.
+  prepare_background(img, w, h, key);
+  int y = 0;
+  for (const FrameImage& part : parts) {
+    const int x = (w - part.w) / 2;
+    for (int row=0; row<part.h; ++row) {
+      std::memcpy(&img.rgb[(size_t(y + row) * w + x) * 3],
+                  &part.rgb[size_t(row) * part.w * 3], size_t(part.w) * 3);
     }
+    y += part.h + COMPOSITE_GAP;
   }
+}
+
+inline int total_leds(const std::vector<StripInfo>& strips) {
+  int n = 0;
+  for (const StripInfo& s : strips) n += s.nleds;
+  return n;
+}
+
+inline bool write_ppm(const std::string& path, const FrameImage& img) {
   FILE* f = std::fopen(path.c_str(), "wb");
   if (!f) return false;
-  std::fprintf(f, "P6\n%d %d\n255\n", w, h);
-  std::fwrite(img.data(), 1, img.size(), f);
+  std::fprintf(f, "P6\n%d %d\n255\n", img.w, img.h);
+  std::fwrite(img.rgb.data(), 1, img.rgb.size(), f);
   std::fclose(f);
   return true;
 }
 
+inline bool write_strip_ppm(const std::string& path,
+                            const uint8_t* rgb,
+                            int nleds,
+                            int scale=24) {
+  static thread_local FrameImage img;
+  render_strip(rgb, nleds, img, scale);
+  return write_ppm(path, img);
+}
+
+inline bool write_ring_ppm(const std::string& path,
+                           const uint8_t* rgb,
+                           int nleds,
+                           int scale=16) {
+  static thread_local FrameImage img;
+  render_ring(rgb, nleds, img, scale);
+  return write_ppm(path, img);
+}
+
 inline bool write_frame_ppm(const std::string& path,
                             const uint8_t* rgb,
                             int nleds,
@@ -77,3 +243,451 @@ inline bool write_frame_ppm(const std::string& path,
   return write_strip_ppm(path, rgb, nleds);
 }
 
+inline bool write_frame_ppm(const std::string& path,
+                            const uint8_t* rgb,
+                            const std::vector<StripInfo>& strips) {
+  if (strips.size() == 1) {
+    return write_frame_ppm(path, rgb, strips[0].nleds, strips[0].layout);
+  }
+  static thread_local FrameImage img;
+  render_frame(rgb, strips, img);
+  return write_ppm(path, img);
+}
+
+// Frame stream: every frame of a recording in one file.
+//
+//   offset  size  field
+//   0       4     magic "KLFS"
+//   4       2     version (1, or 2 for a composite of several strips)
+//   6       2     LED count, over all strips
+//   8       1     layout (0 = strip, 1 = ring); unused in version 2
+//   9       1     strip count in version 2, otherwise reserved
+//   10      2     frames per second
+//   12      4     frame count, or 0 if the writer did not finish
+//
+// Version 2 follows this with 4 bytes per strip: LED count (2), layout (1)
+// and a reserved byte. Then come frame count * LED count * 3 bytes of RGB,
+// each frame holding the strips in order. Fields are little-endian. A
+// stream whose frame count is 0 is read to end of file.
+constexpr char FRAME_STREAM_MAGIC[4] = {'K', 'L', 'F', 'S'};
+constexpr uint16_t FRAME_STREAM_VERSION = 1;
+constexpr uint16_t FRAME_STREAM_COMPOSITE_VERSION = 2;
+constexpr size_t FRAME_STREAM_HEADER_SIZE = 16;
+constexpr size_t FRAME_STREAM_STRIP_SIZE = 4;
+
+struct FrameStreamInfo {
+  int nleds = 0;
+  Layout layout = Layout::Strip;
+  int fps = 60;
+  uint32_t frames = 0;
+  // Always at least one entry once a stream is open.
+  std::vector<StripInfo> strips;
+};
+
+class FrameStreamWriter {
+public:
+  ~FrameStreamWriter() { close(); }
+
+  bool open(const std::string& path, int nleds, Layout layout, int fps) {
+    return open(path, std::vector<StripInfo>{{nleds, layout}}, fps);
+  }
+
+  bool open(const std::string& path, const std::vector<StripInfo>& strips, int fps) {
+    close();
+    if (strips.empty() || strips.size() > 255) return false;
+    f_ = std::fopen(path.c_str(), "wb");
+    if (!f_) return false;
+    // Frames are small; let stdio batch a few hundred of them per write.
+    std::setvbuf(f_, nullptr, _IOFBF, 1 << 20);
+    info_.nleds = total_leds(strips);
+    info_.layout = strips[0].layout;
+    info_.fps = fps;
+    info_.frames = 0;
+    info_.strips = strips;
+    write_header();
+    return true;
+  }
+
+  bool is_open() const { return f_ != nullptr; }
+  int nleds() const { return info_.nleds; }
+  const std::vector<StripInfo>& strips() const { return info_.strips; }
+
+  void write(const uint8_t* rgb) {
+    std::fwrite(rgb, 1, size_t(info_.nleds) * 3, f_);
+    info_.frames++;
+  }
+
+  void close() {
+    if (!f_) return;
+    std::fseek(f_, 0, SEEK_SET);
+    write_header();
+    std::fclose(f_);
+    f_ = nullptr;
+  }
+
+private:
+  void write_header() {
+    const bool composite = info_.strips.size() > 1;
+    uint8_t h[FRAME_STREAM_HEADER_SIZE] = {};
+    std::copy(FRAME_STREAM_MAGIC, FRAME_STREAM_MAGIC + 4, h);
+    put16(h + 4, composite ? FRAME_STREAM_COMPOSITE_VERSION : FRAME_STREAM_VERSION);
+    put16(h + 6, uint16_t(info_.nleds));
+    h[8] = info_.layout == Layout::Ring ? 1 : 0;
+    h[9] = composite ? uint8_t(info_.strips.size()) : 0;
+    put16(h + 10, uint16_t(info_.fps));
+    put16(h + 12, uint16_t(info_.frames));
+    put16(h + 14, uint16_t(info_.frames >> 16));
+    std::fwrite(h, 1, sizeof(h), f_);
+    if (!composite) return;
+    for (const StripInfo& strip : info_.strips) {
+      uint8_t e[FRAME_STREAM_STRIP_SIZE] = {};
+      put16(e, uint16_t(strip.nleds));
+      e[2] = strip.layout == Layout::Ring ? 1 : 0;
+      std::fwrite(e, 1, sizeof(e), f_);
+    }
+  }
+
+  static void put16(uint8_t* p, uint16_t v) {
+    p[0] = uint8_t(v);
+    p[1] = uint8_t(v >> 8);
+  }
+
+  FILE* f_ = nullptr;
+  FrameStreamInfo info_;
+};
+
+class FrameStreamReader {
+public:
+  ~FrameStreamReader() {
+    if (f_) std::fclose(f_);
+  }
+
+  bool open(const std::string& path) {
+    f_ = std::fopen(path.c_str(), "rb");
+    if (!f_) return false;
+    uint8_t h[FRAME_STREAM_HEADER_SIZE];
+    if (std::fread(h, 1, sizeof(h), f_) != sizeof(h)) return false;
+    if (!std::equal(h, h + 4, FRAME_STREAM_MAGIC)) return false;
+    const uint16_t version = get16(h + 4);
+    if (version != FRAME_STREAM_VERSION &&
+        version != FRAME_STREAM_COMPOSITE_VERSION) return false;
+    info_.nleds = get16(h + 6);
+    info_.layout = h[8] == 1 ? Layout::Ring : Layout::Strip;
+    info_.fps = get16(h + 10);
+    info_.frames = get16(h + 12) | (uint32_t(get16(h + 14)) << 16);
+    info_.strips.clear();
+    if (version == FRAME_STREAM_COMPOSITE_VERSION) {
+      for (int s=0; s<h[9]; ++s) {
+        uint8_t e[FRAME_STREAM_STRIP_SIZE];
+        if (std::fread(e, 1, sizeof(e), f_) != sizeof(e)) return false;
+        info_.strips.push_back({get16(e), e[2] == 1 ? Layout::Ring : Layout::Strip});
+      }
+      if (info_.strips.empty() || total_leds(info_.strips) != info_.nleds) return false;
+    } else {
+      info_.strips.push_back({info_.nleds, info_.layout});
+    }
+    return info_.nleds > 0 && info_.fps > 0;
+  }
+
+  const FrameStreamInfo& info() const { return info_; }
+
+  // Reads the next frame's RGB triples; false at the end of the stream.
+  bool next(std::vector<uint8_t>& rgb) {
+    if (info_.frames && read_ == info_.frames) return false;
+    rgb.resize(size_t(info_.nleds) * 3);
+    if (std::fread(rgb.data(), 1, rgb.size(), f_) != rgb.size()) return false;
+    read_++;
+    return true;
+  }
+
+private:
+  static uint16_t get16(const uint8_t* p) {
+    return uint16_t(p[0] | (p[1] << 8));
+  }
+
+  FILE* f_ = nullptr;
+  FrameStreamInfo info_;
+  uint32_t read_ = 0;
+};
+
+// GIF output. LED frames use few colours, so the palette is fixed for the
+// whole file: GifPalette collects every LED colour of the recording (plus
+// the black background) and GifWriter maps pixels onto it. Each frame
+// stores only the rectangle that changed since the last one, and a frame
+// identical to the one before it just lengthens that frame's delay.
+class GifPalette {
+public:
+  GifPalette() { colors_.insert(0); }
+
+  void add(const uint8_t* rgb, int nleds) {
+    for (int i=0; i<nleds; ++i) {
+      colors_.insert(pack(rgb + i*3));
+    }
+  }
+
+  // Palette as RGB triples: the exact colours if there are at most 256,
+  // otherwise a 6x7x6 colour cube that GifWriter maps to the nearest entry.
+  std::vector<uint8_t> rgb() const {
+    std::vector<uint8_t> out;
+    if (colors_.size() <= 256) {
+      std::vector<uint32_t> sorted(colors_.begin(), colors_.end());
+      std::sort(sorted.begin(), sorted.end());
+      for (uint32_t c : sorted) {
+        out.push_back(uint8_t(c >> 16));
+        out.push_back(uint8_t(c >> 8));
+        out.push_back(uint8_t(c));
+      }
+      return out;
+    }
+    for (int r=0; r<6; ++r)
+      for (int g=0; g<7; ++g)
+        for (int b=0; b<6; ++b) {
+          out.push_back(uint8_t(r * 255 / 5));
+          out.push_back(uint8_t(g * 255 / 6));
+          out.push_back(uint8_t(b * 255 / 5));
+        }
+    return out;
+  }
+
+  static uint32_t pack(const uint8_t* p) {
+    return (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+  }
+
+private:
+  std::unordered_set<uint32_t> colors_;
+};
+
+class GifWriter {
+public:
+  // Browsers stretch frames shorter than this to 100 ms, so shorter
+  // frames are dropped and their time given to the next one.
+  static constexpr uint32_t MIN_DELAY_CS = 2;
+
+  ~GifWriter() { close(); }
+
+  bool open(const std::string& path, int w, int h,
+            const std::vector<uint8_t>& palette) {
+    close();
+    f_ = std::fopen(path.c_str(), "wb");
+    if (!f_) return false;
+    std::setvbuf(f_, nullptr, _IOFBF, 1 << 20);
+    w_ = w;
+    h_ = h;
+    palette_ = palette;
+    index_.clear();
+    last_color_ = ~0u;
+    bits_ = 1;
+    while ((1 << bits_) < int(palette_.size() / 3)) ++bits_;
+    prev_.clear();
+    pending_.clear();
+    pending_delay_ = 0;
+
+    std::fwrite("GIF89a", 1, 6, f_);
+    put16(uint16_t(w));
+    put16(uint16_t(h));
+    std::fputc(0x80 | ((bits_ - 1) << 4) | (bits_ - 1), f_);
+    std::fputc(0, f_); // background colour
+    std::fputc(0, f_); // aspect ratio
+    std::vector<uint8_t> table(size_t(3) << bits_, 0);
+    std::copy(palette_.begin(), palette_.end(), table.begin());
+    std::fwrite(table.data(), 1, table.size(), f_);
+    // NETSCAPE2.0 extension: loop forever.
+    static const uint8_t loop[] = {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C',
+                                   'A', 'P', 'E', '2', '.', '0', 0x03, 0x01,
+                                   0x00, 0x00, 0x00};
+    std::fwrite(loop, 1, sizeof(loop), f_);
+    return true;
+  }
+
+  bool is_open() const { return f_ != nullptr; }
+
+  // Adds a w x h RGB24 image shown for delay_cs hundredths of a second.
+  void add(const std::vector<uint8_t>& img, uint32_t delay_cs) {
+    index_image(img, cur_);
+    if (!pending_.empty() &&
+        (cur_ == pending_ || pending_delay_ < MIN_DELAY_CS)) {
+      if (cur_ != pending_) pending_.swap(cur_);
+      pending_delay_ += delay_cs;
+      return;
+    }
+    flush();
+    pending_.swap(cur_);
+    pending_delay_ = delay_cs;
+  }
+
+  bool close() {
+    if (!f_) return true;
+    flush();
+    std::fputc(0x3B, f_);
+    bool ok = !std::ferror(f_);
+    std::fclose(f_);
+    f_ = nullptr;
+    return ok;
+  }
+
+private:
+  void index_image(const std::vector<uint8_t>& img, std::vector<uint8_t>& out) {
+    out.resize(size_t(w_) * h_);
+    for (size_t i=0; i<out.size(); ++i) {
+      uint32_t c = GifPalette::pack(&img[i*3]);
+      if (c != last_color_) {
+        last_color_ = c;
+        last_index_ = lookup(c);
+      }
+      out[i] = last_index_;
+    }
+  }
+
+  uint8_t lookup(uint32_t c) {
+    auto it = index_.find(c);
+    if (it != index_.end()) return it->second;
+    int r = int(c >> 16), g = int((c >> 8) & 0xFF), b = int(c & 0xFF);
+    int best = 0, best_d = 1 << 30;
+    for (size_t i=0; i<palette_.size()/3; ++i) {
+      int dr = r - palette_[i*3], dg = g - palette_[i*3+1], db = b - palette_[i*3+2];
+      int d = dr*dr + dg*dg + db*db;
+      if (d < best_d) {
+        best_d = d;
+        best = int(i);
+      }
+    }
+    index_[c] = uint8_t(best);
+    return uint8_t(best);
+  }
+
+  // Writes the pending frame, cropped to what changed since the last one.
+  void flush() {
+    if (pending_.empty()) return;
+    int x0 = 0, y0 = 0, x1 = w_, y1 = h_;
+    if (!prev_.empty()) {
+      x0 = w_; y0 = h_; x1 = 0; y1 = 0;
+      for (int y=0; y<h_; ++y) {
+        const uint8_t* a = &pending_[size_t(y) * w_];
+        const uint8_t* b = &prev_[size_t(y) * w_];
+        for (int x=0; x<w_; ++x) {
+          if (a[x] != b[x]) {
+            x0 = std::min(x0, x); x1 = std::max(x1, x + 1);
+            y0 = std::min(y0, y); y1 = std::max(y1, y + 1);
+          }
+        }
+      }
+      // Only reached when a dropped short frame changed something and the
+      // next one changed it back; keep one pixel so the delay is kept.
+      if (x1 == 0) { x0 = 0; y0 = 0; x1 = 1; y1 = 1; }
+    }
+
+    uint32_t delay = std::min<uint32_t>(pending_delay_, 0xFFFF);
+    const uint8_t gce[] = {0x21, 0xF9, 0x04, 0x04, // do not dispose
+                           uint8_t(delay), uint8_t(delay >> 8), 0x00, 0x00};
+    std::fwrite(gce, 1, sizeof(gce), f_);
+    std::fputc(0x2C, f_);
+    put16(uint16_t(x0));
+    put16(uint16_t(y0));
+    put16(uint16_t(x1 - x0));
+    put16(uint16_t(y1 - y0));
+    std::fputc(0, f_); // no local colour table, not interlaced
+    write_lzw(x0, y0, x1, y1);
+    prev_.swap(pending_);
+    pending_.clear();
+  }
+
+  // GIF LZW: variable-width codes, LSB first, in sub-blocks of up to 255
+  // bytes. The string table is a hash of (prefix code, next index).
+  void write_lzw(int x0, int y0, int x1, int y1) {
+    const int min_bits = std::max(bits_, 2);
+    const int clear = 1 << min_bits;
+    const int eoi = clear + 1;
+    std::fputc(min_bits, f_);
+    block_len_ = 0;
+    acc_ = 0;
+    acc_bits_ = 0;
+
+    if (table_.empty()) table_.resize(HASH_SIZE);
+    std::fill(table_.begin(), table_.end(), Entry{});
+    int next = eoi + 1;
+    int width = min_bits + 1;
+    put_code(clear, width);
+
+    int prefix = -1;
+    for (int y=y0; y<y1; ++y) {
+      const uint8_t* row = &pending_[size_t(y) * w_];
+      for (int x=x0; x<x1; ++x) {
+        int k = row[x];
+        if (prefix < 0) {
+          prefix = k;
+          continue;
+        }
+        uint32_t key = (uint32_t(prefix) << 8) | uint32_t(k);
+        size_t h = (key * 2654435761u) % HASH_SIZE;
+        while (table_[h].code && table_[h].key != key) h = (h + 1) % HASH_SIZE;
+        if (table_[h].code) {
+          prefix = table_[h].code;
+          continue;
+        }
+        put_code(prefix, width);
+        if (next < 4096) {
+          table_[h] = Entry{key, uint16_t(next)};
+          if (next++ == (1 << width) && width < 12) ++width;
+        } else {
+          put_code(clear, width);
+          std::fill(table_.begin(), table_.end(), Entry{});
+          next = eoi + 1;
+          width = min_bits + 1;
+        }
+        prefix = k;
+      }
+    }
+    if (prefix >= 0) put_code(prefix, width);
+    put_code(eoi, width);
+    if (acc_bits_ > 0) put_byte(uint8_t(acc_));
+    if (block_len_) {
+      std::fputc(block_len_, f_);
+      std::fwrite(block_, 1, block_len_, f_);
+    }
+    std::fputc(0, f_);
+  }
+
+  void put_code(int code, int width) {
+    acc_ |= uint32_t(code) << acc_bits_;
+    acc_bits_ += width;
+    while (acc_bits_ >= 8) {
+      put_byte(uint8_t(acc_));
+      acc_ >>= 8;
+      acc_bits_ -= 8;
+    }
+  }
+
+  void put_byte(uint8_t b) {
+    block_[block_len_++] = b;
+    if (block_len_ == 255) {
+      std::fputc(255, f_);
+      std::fwrite(block_, 1, 255, f_);
+      block_len_ = 0;
+    }
+  }
+
+  void put16(uint16_t v) {
+    std::fputc(v & 0xFF, f_);
+    std::fputc(v >> 8, f_);
+  }
+
+  struct Entry {
+    uint32_t key = 0;
+    uint16_t code = 0; // 0 = empty; real codes are above the clear code
+  };
+  static constexpr size_t HASH_SIZE = 5003 * 2;
+
+  FILE* f_ = nullptr;
+  int w_ = 0, h_ = 0, bits_ = 1;
+  std::vector<uint8_t> palette_;
+  std::unordered_map<uint32_t, uint8_t> index_;
+  uint32_t last_color_ = ~0u;
+  uint8_t last_index_ = 0;
+  std::vector<uint8_t> prev_, pending_, cur_;
+  uint32_t pending_delay_ = 0;
+  std::vector<Entry> table_;
+  uint8_t block_[255];
+  int block_len_ = 0;
+  uint32_t acc_ = 0;
+  int acc_bits_ = 0;
+};
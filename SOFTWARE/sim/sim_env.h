@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdlib>
+#include <map>
+#include <string>
+
+// Settings for the sketch being rendered. The batch renderer runs several
+// sketches at once, one per thread, so sketches read their settings through
+// sim_getenv(): the current job's value if it has one, otherwise the process
+// environment.
+using SimEnv = std::map<std::string, std::string>;
+inline thread_local const SimEnv* g_sim_env = nullptr;
+
+inline const char* sim_getenv(const char* name) {
+  if (g_sim_env) {
+    auto it = g_sim_env->find(name);
+    return it == g_sim_env->end() ? nullptr : it->second.c_str();
+  }
+  return std::getenv(name);
+}
+
+// Per-thread replacement for std::rand(), reseeded for every job so
+// parallel renders stay repeatable.
+inline thread_local uint32_t g_sim_rand_state = 1;
+
+inline void sim_srand(uint32_t seed) { g_sim_rand_state = seed; }
+
+inline int sim_rand() {
+  g_sim_rand_state = g_sim_rand_state * 1103515245u + 12345u;
+  return (int)((g_sim_rand_state >> 16) & 0x7fff);
+}
@@ -1,49 +1,203 @@
 #include "arduino_stubs.h"
 #include "fastled_shim.h"
 #include "frame_recorder.h"
+#include "sim_env.h"
+#include "work_pool.h"
+#include "third_party/arduinojson/json.h"
+#include <atomic>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
 #include <vector>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <string>
+#include <thread>
 
 // declare user sketch entry points
 void setup();
 void loop();
 int animation_duration_frames();
 
-static int g_frame = 0;
-static Layout g_layout = Layout::Strip;
+static const int target_fps = 60;
 
-static void record_frame(const CRGB* leds, int n, uint8_t brightness) {
-  std::vector<uint8_t> row(n*3);
-  for (int i=0;i<n;++i) {
-    row[i*3+0] = (leds[i].r * brightness) / 255;
-    row[i*3+1] = (leds[i].g * brightness) / 255;
-    row[i*3+2] = (leds[i].b * brightness) / 255;
+// Recorder state for the clip being rendered on this thread.
+static thread_local int g_frame = 0;
+static thread_local Layout g_layout = Layout::Strip;
+static thread_local bool g_pack_layout = false;
+static thread_local std::vector<StripInfo> g_strips;
+
+// FRAME_STREAM=<path> records every frame into one stream file (see
+// frame_recorder.h) instead of one PPM per frame under frames/.
+static thread_local std::string g_stream_path;
+static thread_local FrameStreamWriter g_stream;
+static thread_local bool g_stream_failed = false;
+static thread_local std::vector<uint8_t> g_row;
+
+// LAYOUT=pack draws the controllers as the pack mounts them: the powercell
+// bar, the cyclotron ring, then the future strip. Any other layout applies
+// to every controller.
+static Layout strip_layout(int index) {
+  if (g_pack_layout) return index == 1 ? Layout::Ring : Layout::Strip;
+  return g_layout;
+}
+
+static void record_frame(const FastLED::Controller* controllers, int count,
+                         uint8_t brightness) {
+  g_strips.resize(count);
+  int n = 0;
+  for (int s=0; s<count; ++s) {
+    g_strips[s] = {controllers[s].nleds, strip_layout(s)};
+    n += controllers[s].nleds;
+  }
+  g_row.resize(n*3);
+  uint8_t* out = g_row.data();
+  for (int s=0; s<count; ++s) {
+    const CRGB* leds = controllers[s].leds;
+    for (int i=0;i<controllers[s].nleds;++i) {
+      *out++ = (leds[i].r * brightness) / 255;
+      *out++ = (leds[i].g * brightness) / 255;
+      *out++ = (leds[i].b * brightness) / 255;
+    }
+  }
+  if (!g_stream_path.empty()) {
+    if (!g_stream.is_open() && !g_stream_failed) {
+      g_stream_failed = !g_stream.open(g_stream_path, g_strips, target_fps);
+    }
+    if (g_stream.is_open() && n == g_stream.nleds()) g_stream.write(g_row.data());
+    g_frame++;
+    return;
   }
   char name[256];
   std::snprintf(name, sizeof(name), "frames/frame_%05d.ppm", g_frame++);
-  std::filesystem::create_directories("frames");
-  write_frame_ppm(name, row.data(), n, g_layout);
+  if (g_frame == 1) std::filesystem::create_directories("frames");
+  write_frame_ppm(name, g_row.data(), g_strips);
 }
 
-int main() {
-  if (const char* env = std::getenv("LAYOUT")) {
+// Renders one clip with the settings sim_getenv() returns on this thread.
+// Returns false if the output could not be written.
+static bool render_clip() {
+  g_frame = 0;
+  g_layout = Layout::Strip;
+  g_pack_layout = false;
+  g_stream_path.clear();
+  g_stream_failed = false;
+  g_sim_clock_us = 0;
+  if (const char* env = sim_getenv("LAYOUT")) {
     std::string val(env);
     if (val == "ring") g_layout = Layout::Ring;
+    if (val == "pack") g_pack_layout = true;
+  }
+  if (const char* env = sim_getenv("FRAME_STREAM")) {
+    g_stream_path = env;
   }
+  FastLED::reset();
   FastLED::g_show_cb = record_frame;
   setup();
-  const int target_fps = 60;
   const int frame_ms = 1000/target_fps;
   int total_frames = animation_duration_frames();
-  if (const char* dur = std::getenv("DURATION_MS")) {
+  if (const char* dur = sim_getenv("DURATION_MS")) {
     total_frames = std::atoi(dur) / frame_ms;
   }
   for (int i = 0; i < total_frames; ++i) {
     loop();
     delay(frame_ms);
   }
+  g_stream.close();
+  return !g_stream_failed;
+}
+
+// Renders every entry of an animation_configs.json file into
+// <out_dir>/<name>_<led>_<color>.klfs on a work-stealing pool.
+static int render_batch(const std::string& config_path,
+                        const std::string& out_dir,
+                        unsigned workers) {
+  std::ifstream in(config_path, std::ios::binary);
+  if (!in) {
+    std::fprintf(stderr, "cannot read %s\n", config_path.c_str());
+    return 1;
+  }
+  std::string text((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  FLArduinoJson::JsonDocument doc;
+  FLArduinoJson::DeserializationError err =
+      FLArduinoJson::deserializeJson(doc, text.c_str(), text.size());
+  if (err) {
+    std::fprintf(stderr, "%s: %s\n", config_path.c_str(), err.c_str());
+    return 1;
+  }
+
+  std::filesystem::create_directories(out_dir);
+  std::vector<SimEnv> envs;
+  std::set<std::string> seen;
+  for (FLArduinoJson::JsonObject cfg : doc.as<FLArduinoJson::JsonArray>()) {
+    const char* name = cfg["name"] | "";
+    const char* color = cfg["color"] | "white";
+    const char* layout = cfg["layout"] | "strip";
+    int led = cfg["led"] | 0;
+    if (!*name || led <= 0) {
+      std::fprintf(stderr, "%s: skipping entry without name or led\n",
+                   config_path.c_str());
+      continue;
+    }
+    std::string path = out_dir + "/" + name +
+                       (std::strcmp(layout, "pack") == 0 ? "_pack_" : "_") +
+                       std::to_string(led) + "_" + color + ".klfs";
+    if (!seen.insert(path).second) continue; // same clip listed twice
+    envs.push_back({{"ANIMATION_NAME", name},
+                    {"LED_COUNT", std::to_string(led)},
+                    {"COLOR", color},
+                    {"LAYOUT", layout},
+                    {"FRAME_STREAM", path}});
+  }
+
+  std::atomic<int> failures{0};
+  std::vector<WorkStealingPool::Job> jobs;
+  for (const SimEnv& env : envs) {
+    jobs.push_back([&env, &failures] {
+      g_sim_env = &env;
+      if (!render_clip()) {
+        std::fprintf(stderr, "cannot write %s\n",
+                     env.at("FRAME_STREAM").c_str());
+        failures++;
+      }
+      g_sim_env = nullptr;
+    });
+  }
+  WorkStealingPool(workers).run(std::move(jobs));
+  std::printf("%zu clips on %u threads\n", envs.size(), workers);
+  return failures ? 1 : 0;
+}
+
+// sim_led                                  one clip, configured from the
+//                                          environment
+// sim_led --configs FILE [--out DIR] [--jobs N]
+//                                          every clip in FILE, in parallel
+int main(int argc, char** argv) {
+  std::string configs, out_dir = "frames";
+  unsigned workers = std::thread::hardware_concurrency();
+  for (int i = 1; i < argc; ++i) {
+    if (i + 1 < argc && std::strcmp(argv[i], "--configs") == 0) {
+      configs = argv[++i];
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--out") == 0) {
+      out_dir = argv[++i];
+    } else if (i + 1 < argc && std::strcmp(argv[i], "--jobs") == 0) {
+      workers = (unsigned)std::atoi(argv[++i]);
+    } else {
+      std::fprintf(stderr,
+                   "usage: sim_led [--configs FILE [--out DIR] [--jobs N]]\n");
+      return 2;
+    }
+  }
+  if (!configs.empty()) {
+    return render_batch(configs, out_dir, workers ? workers : 1);
+  }
+  if (!render_clip()) {
+    std::fprintf(stderr, "cannot write %s\n", g_stream_path.c_str());
+    return 1;
+  }
   return 0;
 }
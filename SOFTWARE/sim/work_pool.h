@@ -0,0 +1,66 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a fixed batch of jobs on a work-stealing pool. Jobs are dealt out
+// round-robin; each worker takes from the back of its own queue and, once
+// that is empty, steals from the front of the others', so a few long clips
+// do not leave the rest of the pool idle. No job adds more work, so a
+// worker that finds every queue empty is done.
+class WorkStealingPool {
+public:
+  using Job = std::function<void()>;
+
+  explicit WorkStealingPool(unsigned workers)
+      : queues_(workers ? workers : 1) {}
+
+  void run(std::vector<Job> jobs) {
+    const size_t n = queues_.size();
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      queues_[i % n].jobs.push_back(std::move(jobs[i]));
+    }
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < n; ++w) {
+      threads.emplace_back([this, w] { work(w); });
+    }
+    for (auto& t : threads) t.join();
+  }
+
+private:
+  struct Queue {
+    std::mutex lock;
+    std::deque<Job> jobs;
+  };
+
+  bool take(size_t w, Job& job) {
+    {
+      Queue& own = queues_[w];
+      std::lock_guard<std::mutex> g(own.lock);
+      if (!own.jobs.empty()) {
+        job = std::move(own.jobs.back());
+        own.jobs.pop_back();
+        return true;
+      }
+    }
+    for (size_t k = 1; k < queues_.size(); ++k) {
+      Queue& other = queues_[(w + k) % queues_.size()];
+      std::lock_guard<std::mutex> g(other.lock);
+      if (!other.jobs.empty()) {
+        job = std::move(other.jobs.front());
+        other.jobs.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work(size_t w) {
+    Job job;
+    while (take(w, job)) job();
+  }
+
+  std::vector<Queue> queues_;
+};
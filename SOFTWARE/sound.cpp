@@ -102,6 +102,14 @@ void fire_department(uint8_t fire_type) {
  *          specific sound cues.
  */
 void sleep_align_wandlights(void) {
+  sleep_ms(wandlights_align_ms());
+}
+
+/**
+ * @brief Looks up the wand light alignment delay for the current pack mode.
+ * @return The entry of `pack_sleep_align_ms` for the pack type and mode.
+ */
+uint32_t wandlights_align_ms(void) {
   PackType type = config_pack_type();
   uint8_t _pack_index = 0;
   switch (type) {
@@ -118,7 +126,7 @@ void sleep_align_wandlights(void) {
   default:
     _pack_index = 10;
   }
-  sleep_ms(pack_sleep_align_ms[_pack_index]);
+  return pack_sleep_align_ms[_pack_index];
 }
 
 #ifdef __cplusplus
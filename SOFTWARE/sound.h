@@ -39,6 +39,12 @@ void fire_department(uint8_t fire_type);
  */
 void sleep_align_wandlights(void);
 
+/**
+ * @brief The delay `sleep_align_wandlights` would block for, in milliseconds.
+ * @details For tasks, which wait it out with `task_sleep_ms` instead.
+ */
+uint32_t wandlights_align_ms(void);
+
 /**
  * @brief Initializes the sound subsystem.
  * @details This function should be called once at startup to initialize the
@@ -5,65 +5,267 @@
  *          serial sound module (like a DFPlayer Mini). It handles sending
  *          commands for playing, stopping, and managing volume by writing
  *          byte commands over a UART serial connection.
+ *
+ *          Frames go through a transmit ring: the writer pushes what fits
+ *          into the UART FIFO straight away and the TX interrupt sends the
+ *          rest. The ring, the held stop and the BUSY tracking state are
+ *          shared between the main loop and the pack timer ISR, both on
+ *          core0, so writers mask interrupts while they touch them. That
+ *          only locks out core0, so every command must come from core0; in
+ *          dual-core builds a call from the LED core fails an `assert`.
  * @copyright
  *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
  *   Licensed under the MIT License. See LICENSE file for details.
  */
 
 #include "sound_module.h"
+#include <assert.h>
 #include "klystron_IO_support.h"
 #include "pack_config.h"
 #include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 #include "hardware/uart.h"
+#ifdef KLYSTRON_DUAL_CORE
+#include "led_core.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+static_assert((SOUND_TX_RING_SIZE & (SOUND_TX_RING_SIZE - 1)) == 0,
+              "SOUND_TX_RING_SIZE must be a power of two");
+
+/** @brief Bytes in one command frame. */
+#define SOUND_FRAME_LEN 8
+
+/** @brief Command bytes of the frames this driver sends. */
+enum {
+    SOUND_CMD_VOLUME = 0x06,
+    SOUND_CMD_LOOP = 0x08,
+    SOUND_CMD_RESUME = 0x0D,
+    SOUND_CMD_PAUSE = 0x0E,
+    SOUND_CMD_PLAY = 0x0F,
+    SOUND_CMD_STOP = 0x16,
+};
+
+static uint8_t tx_ring[SOUND_TX_RING_SIZE];
+static volatile uint32_t tx_head = 0; // next byte to hand to the UART
+static volatile uint32_t tx_tail = 0; // next free byte
+
+static volatile bool stop_held = false;     // stop waiting for sound_isr()
+static volatile bool start_pending = false; // play sent, BUSY not seen yet
+static absolute_time_t start_deadline;
+static bool busy_last = false;
+
+static sound_notify_fn notify_fn = NULL;
+static void *notify_context = NULL;
+
+/**
+ * @brief True while the module holds its BUSY pin active.
+ */
+static inline bool busy_active(void) {
+    return gpio_get(pack_sound_busy_pin) == pack_sound_busy_level;
+}
+
+/**
+ * @brief Moves queued bytes into the UART FIFO until it is full.
+ * @details Leaves the TX interrupt enabled only while bytes remain. Called
+ *          with interrupts masked or from the UART interrupt itself.
+ */
+static void tx_pump(void) {
+    uint32_t head = tx_head;
+    while (head != tx_tail && uart_is_writable(uart0)) {
+        uart_putc_raw(uart0, (char)tx_ring[head & (SOUND_TX_RING_SIZE - 1)]);
+        head++;
+    }
+    tx_head = head;
+    uart_set_irq_enables(uart0, false, head != tx_tail);
+}
+
+/**
+ * @brief UART0 interrupt: the FIFO has room for more of the ring.
+ */
+static void sound_uart_irq(void) {
+    tx_pump();
+}
+
+/**
+ * @brief True if the ring has room for another frame.
+ */
+static inline bool tx_has_room(void) {
+    return SOUND_TX_RING_SIZE - (tx_tail - tx_head) >= SOUND_FRAME_LEN;
+}
+
+/**
+ * @brief Appends one command frame to the ring and starts sending it.
+ * @details Call with interrupts masked and `tx_has_room()` true.
+ */
+static void tx_frame(uint8_t cmd, uint8_t param) {
+    const uint8_t frame[SOUND_FRAME_LEN] = {0x7E, 0xFF, 0x06, cmd,
+                                            0x00, 0x00, param, 0xEF};
+    uint32_t tail = tx_tail;
+    for (int i = 0; i < SOUND_FRAME_LEN; i++) {
+        tx_ring[(tail + i) & (SOUND_TX_RING_SIZE - 1)] = frame[i];
+    }
+    tx_tail = tail + SOUND_FRAME_LEN;
+    tx_pump();
+}
+
+/**
+ * @brief Checks that a command comes from core0, which owns the driver.
+ */
+static inline void check_core(void) {
+#ifdef KLYSTRON_DUAL_CORE
+    assert(!led_core_is_current());
+#endif
+}
+
+/**
+ * @brief Masks interrupts once the ring has room for a frame.
+ * @details Only waits when eight frames are already queued.
+ * @return The interrupt state to hand back to `restore_interrupts()`.
+ */
+static uint32_t tx_lock(void) {
+    check_core();
+    while (true) {
+        uint32_t status = save_and_disable_interrupts();
+        if (tx_has_room()) {
+            return status;
+        }
+        restore_interrupts(status);
+        tight_loop_contents();
+    }
+}
+
+/**
+ * @brief Takes the current notification, if any, so it can be finished.
+ * @details Call with interrupts masked.
+ */
+static sound_notify_fn notify_take(void **context) {
+    sound_notify_fn fn = notify_fn;
+    *context = notify_context;
+    notify_fn = NULL;
+    notify_context = NULL;
+    return fn;
+}
+
+/**
+ * @brief Queues a play or loop frame in place of any held stop.
+ * @details The sound it replaces is reported finished once interrupts are
+ *          back on.
+ */
+static void play_frame(uint8_t cmd, uint8_t param, sound_notify_fn fn,
+                       void *context) {
+    void *old_context;
+    uint32_t status = tx_lock();
+    stop_held = false; // the play replaces the track anyway
+    sound_notify_fn old_fn = notify_take(&old_context);
+    notify_fn = fn;
+    notify_context = context;
+    start_pending = true;
+    start_deadline = make_timeout_time_ms(SOUND_START_WAIT_MS);
+    tx_frame(cmd, param);
+    restore_interrupts(status);
+
+    if (old_fn) {
+        old_fn(SOUND_EVENT_FINISHED, old_context);
+    }
+}
+
 /**
  * @brief Initializes the serial interface to the sound module.
- * @details Sets up the UART communication on UART0 (GPIO 0 and 1) and
- *          configures the BUSY pin (GPIO 2) as a pulled-up input.
+ * @details Sets up the UART communication on UART0 (GPIO 0 and 1), its
+ *          transmit interrupt, and the BUSY pin (GPIO 2) as a pulled-up input.
  */
 void sound_init(void) {
     gpio_set_function(0, UART_FUNCSEL_NUM(uart0, 0));
     gpio_set_function(1, UART_FUNCSEL_NUM(uart0, 1));
     uart_init(uart0, pack_sound_baud_rate);
+    uart_set_irq_enables(uart0, false, false);
+    irq_set_exclusive_handler(UART0_IRQ, sound_uart_irq);
+    irq_set_enabled(UART0_IRQ, true);
     gpio_init(pack_sound_busy_pin);
     gpio_set_dir(pack_sound_busy_pin, GPIO_IN);
     gpio_pull_up(pack_sound_busy_pin);
+    busy_last = busy_active();
 }
 
 /**
  * @brief Starts playback of a sound by its index number.
- * @details Sends the "play track by index" command sequence over UART.
+ * @details Queues the "play track by index" command frame.
  * @param sound_index The 1-based index of the sound file to play.
  */
 void sound_start(uint8_t sound_index) {
-    uart_puts(uart0, "\x7E\xFF\x06");
-    uart_putc_raw(uart0, '\x0F');
-    uart_putc_raw(uart0, '\x00');
-    uart_putc_raw(uart0, '\x00');
-    uart_putc_raw(uart0, sound_index);
-    uart_putc_raw(uart0, '\xEF');
+    play_frame(SOUND_CMD_PLAY, sound_index, NULL, NULL);
+}
+
+/**
+ * @brief Starts playback of a sound and reports its BUSY edges.
+ * @details See `sound_module.h`. The previous notification, if any, is
+ *          finished here, as its sound is being replaced.
+ */
+void sound_play_notify(uint8_t sound_index, sound_notify_fn fn, void *context) {
+    play_frame(SOUND_CMD_PLAY, sound_index, fn, context);
+}
+
+/**
+ * @brief Sends any held stop and tracks the BUSY pin.
+ * @details A play counts as started on the next rising edge of BUSY, since the
+ *          module drops BUSY briefly when it switches tracks. If no edge comes
+ *          within `SOUND_START_WAIT_MS`, BUSY is taken as it stands. Edges of
+ *          a notified sound are passed to its `sound_notify_fn` here, in the
+ *          pack timer ISR.
+ */
+void sound_isr(void) {
+    if (stop_held && tx_has_room()) {
+        stop_held = false;
+        tx_frame(SOUND_CMD_STOP, 0x00);
+    }
+
+    bool busy = busy_active();
+    bool report = false;
+    sound_event_t event = SOUND_EVENT_FINISHED;
+    if (start_pending) {
+        if (busy && !busy_last) {
+            start_pending = false;
+            report = true;
+            event = SOUND_EVENT_STARTED;
+        } else if (absolute_time_diff_us(start_deadline, get_absolute_time()) >= 0) {
+            start_pending = false;
+            report = true;
+            event = busy ? SOUND_EVENT_STARTED : SOUND_EVENT_FINISHED;
+        }
+    } else if (!busy && busy_last) {
+        report = true;
+    }
+    busy_last = busy;
+
+    if (report && notify_fn) {
+        sound_notify_fn fn = notify_fn;
+        void *context = notify_context;
+        if (event == SOUND_EVENT_FINISHED) {
+            notify_fn = NULL;
+            notify_context = NULL;
+        }
+        fn(event, context);
+    }
 }
 
 /**
  * @brief Waits until the current sound finishes playing.
- * @details This is a blocking function that polls the sound module's busy
- *          status pin. It can be configured to abort early if the user triggers
+ * @details This is a blocking function that polls `sound_is_playing()`,
+ *          which `sound_isr()` keeps up to date from the pack timer: a sound
+ *          just queued counts as playing until BUSY rises or
+ *          `SOUND_START_WAIT_MS` passes, so there is no separate wait for it
+ *          to start. It can be configured to abort early if the user triggers
  *          a primary activation or shutdown event.
  * @param fire If true, the wait will abort if the main activation switch is pressed.
  * @param shutdown If true, the wait will abort if a pack shutdown is requested.
  */
 void sound_wait_til_end(bool fire, bool shutdown) {
-    int i = 0;
-    while ((gpio_get(pack_sound_busy_pin) == (pack_sound_busy_level ^ 1)) &&
-           (i < 20)) {
-        i++;
-        sleep_ms(10);
-    }
-    while (gpio_get(pack_sound_busy_pin) == pack_sound_busy_level) {
+    while (sound_is_playing()) {
         sleep_ms(10);
         if (fire && fire_sw())
             break;
@@ -75,86 +277,83 @@ void sound_wait_til_end(bool fire, bool shutdown) {
 /**
  * @brief Checks if the sound module is currently playing a sound.
  * @details This is determined by reading the logic level of the sound module's
- *          `BUSY` pin.
+ *          `BUSY` pin, except that a play still waiting for BUSY counts as
+ *          playing and a held stop counts as stopped.
  * @return true if audio is playing, false otherwise.
  */
 bool sound_is_playing(void) {
-    return (gpio_get(pack_sound_busy_pin) == pack_sound_busy_level);
+    return !stop_held && (start_pending || busy_active());
 }
 
 /**
  * @brief Stops the currently playing sound immediately.
- * @details Sends the "stop playback" command sequence over UART.
+ * @details Holds the "stop playback" command for `sound_isr()` to send, so a
+ *          start before the next tick can take its place. A sound that was
+ *          started but has not raised BUSY yet is stopped as well, and a
+ *          sound started with `sound_play_notify()` is reported finished.
  */
 void sound_stop(void) {
-    if (gpio_get(pack_sound_busy_pin) == pack_sound_busy_level) {
-        uart_puts(uart0, "\x7E\xFF\x06");
-        uart_putc_raw(uart0, '\x16');
-        uart_putc_raw(uart0, '\x00');
-        uart_putc_raw(uart0, '\x00');
-        uart_putc_raw(uart0, '\x00');
-        uart_putc_raw(uart0, '\xEF');
+    check_core();
+    void *context = NULL;
+    sound_notify_fn fn = NULL;
+    uint32_t status = save_and_disable_interrupts();
+    if (start_pending || busy_active()) {
+        stop_held = true;
+        start_pending = false;
+        fn = notify_take(&context);
+    }
+    restore_interrupts(status);
+
+    if (fn) {
+        fn(SOUND_EVENT_FINISHED, context);
     }
 }
 
 /**
  * @brief Pauses playback of the current sound.
- * @details Sends the "pause" command sequence over UART.
+ * @details Queues the "pause" command frame while a sound is playing.
  * @note The sound can be resumed from the same position with `sound_resume()`.
  */
 void sound_pause(void) {
-    if (gpio_get(pack_sound_busy_pin) == pack_sound_busy_level) {
-        uart_puts(uart0, "\x7E\xFF\x06");
-        uart_putc_raw(uart0, '\x0E');
-        uart_putc_raw(uart0, '\x00');
-        uart_putc_raw(uart0, '\x00');
-        uart_putc_raw(uart0, '\x00');
-        uart_putc_raw(uart0, '\xEF');
+    uint32_t status = tx_lock();
+    if (!stop_held && busy_active()) {
+        tx_frame(SOUND_CMD_PAUSE, 0x00);
     }
+    restore_interrupts(status);
 }
 
 /**
  * @brief Resumes playback of a previously paused sound.
- * @details Sends the "resume" command sequence over UART.
+ * @details Queues the "resume" command frame.
  */
 void sound_resume(void) {
-    uart_puts(uart0, "\x7E\xFF\x0G");
-    uart_putc_raw(uart0, '\x0D');
-    uart_putc_raw(uart0, '\x00');
-    uart_putc_raw(uart0, '\x00');
-    uart_putc_raw(uart0, '\x00');
-    uart_putc_raw(uart0, '\xEF');
+    uint32_t status = tx_lock();
+    tx_frame(SOUND_CMD_RESUME, 0x00);
+    restore_interrupts(status);
 }
 
 /**
  * @brief Plays a sound in a continuous loop.
- * @details Sends the "play track in loop" command sequence over UART.
+ * @details Queues the "play track in loop" command frame in place of any
+ *          held stop.
  * @param sound_index The index of the sound file to repeat.
  */
 void sound_repeat(uint8_t sound_index) {
-    uart_puts(uart0, "\x7E\xFF\x06");
-    uart_putc_raw(uart0, '\x08');
-    uart_putc_raw(uart0, '\x00');
-    uart_putc_raw(uart0, '\x00');
-    uart_putc_raw(uart0, sound_index + 1);
-    uart_putc_raw(uart0, '\xEF');
+    play_frame(SOUND_CMD_LOOP, sound_index + 1, NULL, NULL);
 }
 
 /**
  * @brief Sets the playback volume level.
- * @details Sends the "set volume" command sequence over UART.
+ * @details Queues the "set volume" command frame.
  * @param volume_level The new volume level, clamped to the maximum defined
  *                     in `pack_config`.
  */
 void sound_volume(uint8_t volume_level) {
-    uart_puts(uart0, "\x7E\xFF\x06");
-    uart_putc_raw(uart0, '\x06');
-    uart_putc_raw(uart0, '\x00');
-    uart_putc_raw(uart0, '\x00');
     if (volume_level > pack_sound_max_volume)
         volume_level = pack_sound_max_volume;
-    uart_putc_raw(uart0, volume_level);
-    uart_putc_raw(uart0, '\xEF');
+    uint32_t status = tx_lock();
+    tx_frame(SOUND_CMD_VOLUME, volume_level);
+    restore_interrupts(status);
 }
 
 #ifdef __cplusplus
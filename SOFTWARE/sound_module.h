@@ -4,6 +4,18 @@
  * @details This file provides the direct interface for controlling an external
  *          serial sound module (like a DFPlayer Mini). It handles sending
  *          commands for playing, stopping, and managing volume.
+ *
+ *          None of the commands wait on the UART. Each one queues its 8-byte
+ *          frame in a transmit ring that the UART interrupt drains, and
+ *          returns. A stop is held back until the next pack timer tick, so a
+ *          stop followed at once by a start goes out as the start alone; the
+ *          module switches tracks on a play command anyway. `sound_isr()`
+ *          watches the BUSY pin from the pack timer, so `sound_is_playing()`
+ *          counts a sound as playing from its play command on, without
+ *          waiting for BUSY to rise, and reports its edges to whoever
+ *          started the sound with `sound_play_notify()`.
+ *
+ *          All of these functions must be called from core0.
  * @copyright
  *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
  *   Licensed under the MIT License. See LICENSE file for details.
@@ -19,6 +31,28 @@
 extern "C" {
 #endif
 
+/** @brief How long a wait for the end of a sound first allows it to start (ms). */
+#define SOUND_START_WAIT_MS 200
+
+/** @brief Bytes in the UART transmit ring: eight command frames. */
+#define SOUND_TX_RING_SIZE 64
+
+/** @brief BUSY pin edges reported to a `sound_notify_fn`. */
+typedef enum {
+    SOUND_EVENT_STARTED,  /**< BUSY went active: the sound is playing. */
+    SOUND_EVENT_FINISHED, /**< The sound ended, was stopped or replaced, or never started. */
+} sound_event_t;
+
+/**
+ * @brief Told when a sound started with `sound_play_notify()` changes state.
+ * @details Runs on core0 with interrupts enabled or from the pack timer
+ *          ISR, so it must be short and must not wait; see
+ *          `sound_play_notify()` for which.
+ * @param event What happened.
+ * @param context The pointer passed to `sound_play_notify()`.
+ */
+typedef void (*sound_notify_fn)(sound_event_t event, void *context);
+
 /**
  * @brief Initializes the serial interface to the sound module.
  * @details Sets up the UART communication and resets the sound module.
@@ -31,11 +65,35 @@ void sound_init(void);
  */
 void sound_start(uint8_t sound_index);
 
+/**
+ * @brief Starts playback of a sound and reports its BUSY edges.
+ * @details Returns as soon as the play command is queued. `fn` is called with
+ *          `SOUND_EVENT_STARTED` once the module raises BUSY and with
+ *          `SOUND_EVENT_FINISHED` once it drops BUSY again; both come from
+ *          `sound_isr()` in the pack timer ISR. If the sound is stopped or
+ *          replaced first, `SOUND_EVENT_FINISHED` is reported straight away
+ *          from the `sound_stop()`, `sound_start()`, `sound_repeat()` or
+ *          `sound_play_notify()` call that did it. If BUSY is still inactive
+ *          `SOUND_START_WAIT_MS` after the play, only `SOUND_EVENT_FINISHED`
+ *          is reported, from `sound_isr()`.
+ * @param sound_index The 1-based index of the sound file to play.
+ * @param fn Callback for the sound's events, or NULL.
+ * @param context Passed back to `fn`.
+ */
+void sound_play_notify(uint8_t sound_index, sound_notify_fn fn, void *context);
+
+/**
+ * @brief Sends any held stop and tracks the BUSY pin.
+ * @details Called from the pack timer ISR every `pack_isr_interval_ms`.
+ */
+void sound_isr(void);
+
 /**
  * @brief Waits until the current sound finishes playing.
- * @details This is a blocking function that polls the sound module's busy
- *          status. It can be configured to abort early if the user triggers
- *          a primary activation or shutdown event.
+ * @details This is a blocking function that polls `sound_is_playing()`, so a
+ *          sound queued but not yet started is waited for and one held for
+ *          stopping is not. It can be configured to abort early if the user
+ *          triggers a primary activation or shutdown event.
  * @param fire If true, the wait will abort if the main activation switch is pressed.
  * @param shutdown If true, the wait will abort if a pack shutdown is requested.
  */
@@ -44,7 +102,8 @@ void sound_wait_til_end(bool fire, bool shutdown);
 /**
  * @brief Checks if the sound module is currently playing a sound.
  * @details This is determined by reading the state of the sound module's
- *          `BUSY` pin.
+ *          `BUSY` pin. A sound that has been started but has not raised BUSY
+ *          yet counts as playing; one that has been stopped does not.
  * @return true if audio is playing, false otherwise.
  */
 bool sound_is_playing(void);
@@ -0,0 +1,79 @@
+/**
+ * @file task_scheduler.cpp
+ * @brief Run-to-completion scheduler for multi-second pack sequences.
+ * @details See `task_scheduler.h`. Running tasks are kept in a small fixed
+ *          table in start order; a task started from another task's step
+ *          first runs on the following pass.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "task_scheduler.h"
+#include "pico/stdlib.h"
+
+static pack_task_t *tasks[TASK_MAX];
+static uint8_t task_count = 0;
+
+void task_start(pack_task_t *task, pack_task_step_fn fn, uint8_t step) {
+    task->step_fn = fn;
+    task->step = step;
+    task->wake = get_absolute_time();
+    task->mark = task->wake;
+    task->running = true;
+    // A task finished earlier in this pass is still in the table until
+    // task_service() compacts it, so `running` cannot tell.
+    for (uint8_t i = 0; i < task_count; i++) {
+        if (tasks[i] == task) {
+            return;
+        }
+    }
+    // TASK_MAX is sized for every sequence at once, so a full table means a
+    // new sequence was added without raising it.
+    if (task_count == TASK_MAX) {
+        panic("task_start: table full (TASK_MAX %d)", TASK_MAX);
+    }
+    tasks[task_count++] = task;
+}
+
+void task_sleep_ms(pack_task_t *task, uint32_t ms, uint8_t step) {
+    task->wake = make_timeout_time_ms(ms);
+    task->step = step;
+}
+
+void task_mark(pack_task_t *task) {
+    task->mark = get_absolute_time();
+}
+
+uint32_t task_elapsed_ms(const pack_task_t *task) {
+    return (uint32_t)(absolute_time_diff_us(task->mark, get_absolute_time()) / 1000);
+}
+
+void task_finish(pack_task_t *task) {
+    task->running = false;
+}
+
+bool task_is_running(const pack_task_t *task) {
+    return task->running;
+}
+
+bool task_service(void) {
+    uint8_t count = task_count;
+    for (uint8_t i = 0; i < count; i++) {
+        pack_task_t *task = tasks[i];
+        if (task->running &&
+            absolute_time_diff_us(get_absolute_time(), task->wake) <= 0) {
+            task->step_fn(task);
+        }
+    }
+
+    // Drop finished tasks, keeping the rest in start order.
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < task_count; i++) {
+        if (tasks[i]->running) {
+            tasks[kept++] = tasks[i];
+        }
+    }
+    task_count = kept;
+    return task_count != 0;
+}
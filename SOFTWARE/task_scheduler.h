@@ -0,0 +1,86 @@
+/**
+ * @file task_scheduler.h
+ * @brief Run-to-completion scheduler for multi-second pack sequences.
+ * @details Start-up, power-down, major mode changes and venting run for
+ *          seconds at a time. Rather than sleeping in a polling loop, each
+ *          one is a task: a step function that does whatever is due, records
+ *          where to pick up in `task->step`, and returns. The main loop calls
+ *          `task_service()` once per pass, which runs one step of every task
+ *          that is due. A step never blocks, so a fire or power-down request
+ *          is seen on the very next pass.
+ *
+ *          Step functions follow the same pattern as `song_monitor`: a
+ *          `switch` over a file-local enum, with cases falling through when
+ *          nothing has to be waited for. State that must survive between
+ *          steps lives in file-scope statics next to the task.
+ * @copyright
+ *   Copyright (c) 2025 GhostLab42 LLC & GBFans LLC
+ *   Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/types.h"
+
+/**
+ * @brief Tasks that can be running at once: one per sequence.
+ * @details Raise it when adding a sequence. Starting a task with the table
+ *          full calls `panic()`.
+ */
+#define TASK_MAX 5
+
+typedef struct pack_task pack_task_t;
+
+/** @brief Advances a task by one step; must return without blocking. */
+typedef void (*pack_task_step_fn)(pack_task_t *task);
+
+/** @brief A resumable sequence. Define one static instance per sequence. */
+struct pack_task {
+    pack_task_step_fn step_fn; /**< Called on every pass while due. */
+    uint8_t step;              /**< Where `step_fn` resumes. */
+    bool running;              /**< False once finished. */
+    absolute_time_t wake;      /**< `step_fn` is not called before this. */
+    absolute_time_t mark;      /**< Start of the current timed wait. */
+};
+
+/**
+ * @brief Starts `task` at `step`, or restarts it if it is already running.
+ * @details Whatever the sequence does up front can be done by the caller
+ *          before starting the task at its first wait. The first step runs on
+ *          the next call to `task_service()`.
+ */
+void task_start(pack_task_t *task, pack_task_step_fn fn, uint8_t step);
+
+/** @brief Moves `task` to `step`, to run after `ms` milliseconds. */
+void task_sleep_ms(pack_task_t *task, uint32_t ms, uint8_t step);
+
+/** @brief Starts a timed wait: `task_elapsed_ms()` counts from here. */
+void task_mark(pack_task_t *task);
+
+/** @brief Milliseconds since the last `task_mark()`. */
+uint32_t task_elapsed_ms(const pack_task_t *task);
+
+/** @brief Ends `task`; called from its own step function. */
+void task_finish(pack_task_t *task);
+
+/** @brief True while `task` has steps left to run. */
+bool task_is_running(const pack_task_t *task);
+
+/**
+ * @brief Runs one step of every running task that is due.
+ * @return true while any task is still running afterwards.
+ */
+bool task_service(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_SCHEDULER_H